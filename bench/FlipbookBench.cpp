@@ -0,0 +1,90 @@
+// Per-frame cost of animating many sprites, split into the three stages the
+// game runs: FlipbookAnimator::Sample, ApplyUvs into the sprite quads, and
+// recording them with DrawList::Sprites.
+//
+//   FlipbookBench [sprites=100000] [frames=300]
+
+#include "../src/anim/Flipbook.h"
+#include "../src/render/DrawList.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+struct StageTimes {
+    const char* name;
+    std::vector<double> us;
+
+    void Print() {
+        std::sort(us.begin(), us.end());
+        double sum = 0.0;
+        for (double v : us) {
+            sum += v;
+        }
+        std::printf("%-16s %10.1f %10.1f %10.1f\n", name, us[us.size() / 2], sum / us.size(), us.back());
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int count = argc > 1 ? std::max(1, std::atoi(argv[1])) : 100000;
+    const int frames = argc > 2 ? std::max(1, std::atoi(argv[2])) : 300;
+
+    // A mix of clip shapes and loop modes, as a crowd of units would have.
+    FlipbookLibrary lib;
+    FlipbookFrame uneven[3];
+    uneven[0].duration = 0.1f;
+    uneven[1].duration = 0.3f;
+    uneven[2].duration = 0.1f;
+    const ClipId clips[] = {
+        lib.AddGridClip(8, 4, 0, 8, 0.1f, FlipbookLoop::Loop),
+        lib.AddGridClip(8, 4, 8, 6, 0.05f, FlipbookLoop::PingPong),
+        lib.AddGridClip(8, 4, 16, 16, 1.0f / 24.0f, FlipbookLoop::Loop),
+        lib.AddClip(uneven, 3, FlipbookLoop::Once),
+    };
+
+    FlipbookAnimator animator(lib);
+    animator.Reserve(count);
+    std::vector<SpriteQuad> quads(count);
+    for (int i = 0; i < count; ++i) {
+        animator.Add(clips[i % 4], 0.5f + (i % 7) * 0.25f, (i % 13) * 0.01f);
+        quads[i].x = static_cast<float>(i % 1000) * 2.0f;
+        quads[i].y = static_cast<float>(i / 1000) * 2.0f;
+        quads[i].w = 16.0f;
+        quads[i].h = 16.0f;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto us = [](Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<double, std::micro>(b - a).count();
+    };
+    StageTimes sample{"Sample", {}};
+    StageTimes apply{"ApplyUvs", {}};
+    StageTimes record{"DrawList::Sprites", {}};
+    DrawList list;
+    for (int f = 0; f < frames; ++f) {
+        const auto t0 = Clock::now();
+        animator.Sample(1.0f / 60.0f);
+        const auto t1 = Clock::now();
+        animator.ApplyUvs(quads.data(), quads.size());
+        const auto t2 = Clock::now();
+        list.Reset();
+        list.Sprites(quads.data(), quads.size(), nullptr);
+        const auto t3 = Clock::now();
+        sample.us.push_back(us(t0, t1));
+        apply.us.push_back(us(t1, t2));
+        record.us.push_back(us(t2, t3));
+    }
+
+    std::printf("sprites=%d frames=%d\n", count, frames);
+    std::printf("%-16s %10s %10s %10s\n", "stage (us)", "median", "mean", "max");
+    sample.Print();
+    apply.Print();
+    record.Print();
+    return 0;
+}
@@ -0,0 +1,151 @@
+// Decode throughput over a directory of images: QOI against PNG, and PNG with
+// the SSE2 unfilter routines against the scalar ones. Files are paired by
+// name, so a corpus holding both foo.png and foo.qoi compares like with like.
+//
+//   ImageDecodeBench <directory> [minSecondsPerFile=0.25]
+
+#include "../src/image/ImageDecoder.h"
+#include "../src/image/PngDecoder.h"
+#include "../src/image/QoiDecoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum Decoder { kQoi, kPngSimd, kPngScalar, kDecoderCount };
+
+const char* const kDecoderNames[kDecoderCount] = {"qoi", "png sse2", "png scalar"};
+
+struct Entry {
+    std::string qoi;
+    std::string png;
+    int width = 0;
+    int height = 0;
+    double ms[kDecoderCount] = {};
+};
+
+struct Total {
+    double ms = 0.0;
+    double pixels = 0.0;
+};
+
+// Milliseconds per decode, or a negative value if the file does not decode.
+template <typename F>
+double TimeDecode(F&& decode, double minSeconds) {
+    using Clock = std::chrono::steady_clock;
+    if (!decode()) {
+        return -1.0;
+    }
+    int runs = 0;
+    const auto start = Clock::now();
+    double elapsed = 0.0;
+    do {
+        decode();
+        ++runs;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (runs < 3 || elapsed < minSeconds);
+    return elapsed * 1000.0 / runs;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::printf("usage: ImageDecodeBench <directory> [minSecondsPerFile=0.25]\n");
+        return 1;
+    }
+    const double minSeconds = argc > 2 ? std::max(0.0, std::atof(argv[2])) : 0.25;
+
+    std::map<std::string, Entry> entries;
+    std::error_code ec;
+    for (const auto& it : std::filesystem::directory_iterator(argv[1], ec)) {
+        if (!it.is_regular_file()) {
+            continue;
+        }
+        std::string ext = it.path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](char c) {
+            return static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+        });
+        Entry& e = entries[it.path().stem().string()];
+        if (ext == ".qoi") {
+            e.qoi = it.path().string();
+        } else if (ext == ".png") {
+            e.png = it.path().string();
+        }
+    }
+    if (ec) {
+        std::printf("cannot read %s: %s\n", argv[1], ec.message().c_str());
+        return 1;
+    }
+
+#if !(defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    std::printf("built without SSE2: both PNG columns use the scalar path\n");
+#endif
+
+    std::printf("%-28s %11s %10s %10s %10s\n", "image", "size", "qoi ms", "png ms", "scalar ms");
+    Total totals[kDecoderCount];
+    std::vector<uint8_t> bytes;
+    std::vector<uint8_t> pixels;
+    for (auto& kv : entries) {
+        Entry& e = kv.second;
+        if (e.qoi.empty() && e.png.empty()) {
+            continue;
+        }
+        for (int d = 0; d < kDecoderCount; ++d) {
+            e.ms[d] = -1.0;
+            const std::string& path = d == kQoi ? e.qoi : e.png;
+            ImageInfo info;
+            if (path.empty() || !ReadFileBytes(path.c_str(), bytes) ||
+                !ReadImageInfo(bytes.data(), bytes.size(), info)) {
+                continue;
+            }
+            if (e.width != 0 && (e.width != info.width || e.height != info.height)) {
+                std::printf("%s: size differs from its pair, skipped\n", path.c_str());
+                continue;
+            }
+            e.width = info.width;
+            e.height = info.height;
+            const size_t pitch = static_cast<size_t>(info.width) * 4;
+            pixels.resize(pitch * info.height);
+            const uint8_t* src = bytes.data();
+            const size_t size = bytes.size();
+            uint8_t* dst = pixels.data();
+            if (d == kQoi) {
+                e.ms[d] = TimeDecode([&] { return QoiDecode(src, size, dst, pitch); }, minSeconds);
+            } else {
+                const bool useSimd = d == kPngSimd;
+                e.ms[d] = TimeDecode([&] { return PngDecode(src, size, dst, pitch, useSimd); }, minSeconds);
+            }
+        }
+
+        char size[32];
+        std::snprintf(size, sizeof(size), "%dx%d", e.width, e.height);
+        std::printf("%-28s %11s", kv.first.c_str(), size);
+        for (int d = 0; d < kDecoderCount; ++d) {
+            if (e.ms[d] < 0.0) {
+                std::printf(" %10s", "-");
+                continue;
+            }
+            std::printf(" %10.3f", e.ms[d]);
+            totals[d].ms += e.ms[d];
+            totals[d].pixels += static_cast<double>(e.width) * e.height;
+        }
+        std::printf("\n");
+    }
+
+    std::printf("\n");
+    for (int d = 0; d < kDecoderCount; ++d) {
+        if (totals[d].ms > 0.0) {
+            std::printf("%-10s %8.1f Mpixel/s over %.1f Mpixel\n", kDecoderNames[d],
+                        totals[d].pixels / (totals[d].ms * 1000.0), totals[d].pixels / 1e6);
+        }
+    }
+    return 0;
+}
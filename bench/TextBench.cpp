@@ -0,0 +1,97 @@
+// Per-frame cost of drawing thousands of labels through TextRenderer, with the
+// layout cache warm (same labels every frame) and cold (new labels every
+// frame), plus the very first frame that also rasterizes every glyph.
+// Rendering goes to the headless backend, so only the CPU side is measured.
+//
+//   TextBench <font.ttf> [labelsPerFrame=5000] [frames=100]
+
+#include "../src/render/DrawList.h"
+#include "../src/render/headless/HeadlessRenderer.h"
+#include "../src/render/text/TextRenderer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Phase {
+    const char* name;
+    int frames;
+    bool freshLabels; // new strings every frame
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::printf("usage: TextBench <font.ttf> [labelsPerFrame=5000] [frames=100]\n");
+        return 1;
+    }
+    const int labels = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5000;
+    const int frames = argc > 3 ? std::max(1, std::atoi(argv[3])) : 100;
+
+    TextRenderer text;
+    if (!text.LoadFont(argv[1], 16.0f)) {
+        std::printf("cannot load font %s\n", argv[1]);
+        return 1;
+    }
+    // Room for every label of a frame, so the warm phase never evicts.
+    text.SetCacheCapacity(static_cast<size_t>(labels) * 2);
+
+    HeadlessRenderer renderer;
+    DrawList list;
+    std::vector<std::string> strings(labels);
+    uint64_t nextLabel = 0;
+    auto makeLabels = [&] {
+        for (std::string& s : strings) {
+            s = "Unit " + std::to_string(nextLabel++) + "  HP 100/100";
+        }
+    };
+    makeLabels();
+
+    const Phase phases[] = {
+        {"first frame (empty atlas)", 1, false},
+        {"warm (same labels)", frames, false},
+        {"cold (new labels)", frames, true},
+    };
+
+    std::printf("labels/frame=%d\n", labels);
+    std::printf("%-28s %10s %10s %12s %12s %10s %12s\n", "phase", "ms/frame", "max ms", "hits/frame",
+                "misses/frame", "quads", "upload px");
+    using Clock = std::chrono::steady_clock;
+    for (const Phase& phase : phases) {
+        const TextStats before = text.Stats();
+        const uint64_t uploadedBefore = renderer.Stats().uploadedPixels;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+        for (int f = 0; f < phase.frames; ++f) {
+            if (phase.freshLabels) {
+                makeLabels(); // outside the timed region
+            }
+            const auto start = Clock::now();
+            list.Reset();
+            for (int i = 0; i < labels; ++i) {
+                text.Draw(static_cast<float>(i % 40) * 48.0f, static_cast<float>(i / 40) * 18.0f, strings[i]);
+            }
+            text.Record(list, renderer);
+            list.Submit(renderer);
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            totalMs += ms;
+            maxMs = std::max(maxMs, ms);
+        }
+        const TextStats& after = text.Stats();
+        std::printf("%-28s %10.3f %10.3f %12.0f %12.0f %10zu %12llu\n", phase.name, totalMs / phase.frames, maxMs,
+                    static_cast<double>(after.layoutHits - before.layoutHits) / phase.frames,
+                    static_cast<double>(after.layoutMisses - before.layoutMisses) / phase.frames, after.quads,
+                    static_cast<unsigned long long>(renderer.Stats().uploadedPixels - uploadedBefore));
+    }
+    const TextStats& s = text.Stats();
+    std::printf("\ntotal: hits=%llu misses=%llu atlas resets=%llu cached layouts=%zu glyphs=%zu\n",
+                static_cast<unsigned long long>(s.layoutHits), static_cast<unsigned long long>(s.layoutMisses),
+                static_cast<unsigned long long>(s.atlasResets), s.cachedLayouts, s.glyphs);
+    return 0;
+}
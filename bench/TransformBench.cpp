@@ -0,0 +1,67 @@
+// Update cost of a 100k-node hierarchy against the number of nodes changed
+// since the previous update, from a single node up to all of them.
+//
+//   TransformBench [nodes=100000] [threads=0 (hardware)]
+
+#include "../src/scene/TransformHierarchy.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main(int argc, char** argv) {
+    const int nodeCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 100000;
+    const unsigned threads = argc > 2 ? static_cast<unsigned>(std::max(0, std::atoi(argv[2]))) : 0;
+
+    using Clock = std::chrono::steady_clock;
+    std::mt19937 rng(1);
+    TransformHierarchy h;
+    h.SetMaxThreads(threads);
+
+    // A shallow forest: a few roots, every other node parented to a random
+    // earlier one, so subtrees vary from single leaves to large branches.
+    std::vector<TransformId> ids;
+    ids.reserve(nodeCount);
+    for (int i = 0; i < nodeCount; ++i) {
+        const TransformId parent = i < 16 ? kInvalidTransform : ids[rng() % ids.size()];
+        ids.push_back(h.Create(parent));
+        Transform2D t;
+        t.x = static_cast<float>(rng() % 100);
+        t.y = static_cast<float>(rng() % 100);
+        t.rotation = (rng() % 100) * 0.01f;
+        h.SetLocal(ids.back(), t);
+    }
+
+    auto start = Clock::now();
+    h.Update();
+    std::printf("nodes=%d threads=%u  first update (flatten + all): %.0f us\n", nodeCount, threads,
+                std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+
+    std::printf("%10s %14s %12s %12s\n", "changed", "nodes updated", "update us", "us/node");
+    const int kRuns = 20;
+    for (int changed = 1; changed <= nodeCount; changed *= 10) {
+        std::vector<double> times;
+        size_t updated = 0;
+        for (int run = 0; run < kRuns; ++run) {
+            for (int k = 0; k < changed; ++k) {
+                const TransformId id = ids[rng() % ids.size()];
+                Transform2D t = h.Local(id);
+                t.x += 1.0f;
+                h.SetLocal(id, t);
+            }
+            start = Clock::now();
+            h.Update();
+            times.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+            updated += h.LastUpdatedCount();
+        }
+        std::sort(times.begin(), times.end());
+        const double median = times[times.size() / 2];
+        const double avgUpdated = static_cast<double>(updated) / kRuns;
+        std::printf("%10d %14.0f %12.1f %12.4f\n", changed, avgUpdated, median,
+                    avgUpdated > 0.0 ? median / avgUpdated : 0.0);
+    }
+    return 0;
+}
@@ -0,0 +1,235 @@
+#include "Flipbook.h"
+#include "../render/DrawList.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr uint32_t kMaxSlotsPerClip = 4096;
+constexpr float kMinFrameDuration = 1.0f / 1000.0f;
+
+// Instances per sampling block: the slot indices of one block stay in L1
+// between the arithmetic loop and the table gather.
+constexpr size_t kSampleBlock = 512;
+
+} // namespace
+
+ClipId FlipbookLibrary::AddClip(const FlipbookFrame* frames, size_t count, FlipbookLoop loop) {
+    if (!frames || count == 0 || count > kMaxSlotsPerClip) {
+        return kInvalidClip;
+    }
+
+    float length = 0.0f;
+    float shortest = 0.0f;
+    float longest = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        const float d = std::max(frames[i].duration, kMinFrameDuration);
+        length += d;
+        shortest = i == 0 ? d : std::min(shortest, d);
+        longest = std::max(longest, d);
+    }
+
+    uint32_t slotCount = static_cast<uint32_t>(count);
+    if (longest - shortest > shortest * 1e-4f) {
+        const float wanted = std::ceil(length / (shortest * 0.25f));
+        slotCount = static_cast<uint32_t>(std::min(wanted, static_cast<float>(kMaxSlotsPerClip)));
+        slotCount = std::max(slotCount, static_cast<uint32_t>(count));
+    }
+
+    Clip clip;
+    clip.firstSlot = static_cast<uint32_t>(slotUv_.size());
+    clip.slotCount = slotCount;
+    clip.length = length;
+    clip.slotsPerSecond = slotCount / length;
+    clip.loop = loop;
+
+    // Each slot shows the frame covering the slot's midpoint.
+    const uint32_t firstUv = static_cast<uint32_t>(uvs_.size());
+    size_t frame = 0;
+    float frameEnd = std::max(frames[0].duration, kMinFrameDuration);
+    for (uint32_t s = 0; s < slotCount; ++s) {
+        const float t = (s + 0.5f) / clip.slotsPerSecond;
+        while (t >= frameEnd && frame + 1 < count) {
+            ++frame;
+            frameEnd += std::max(frames[frame].duration, kMinFrameDuration);
+        }
+        slotUv_.push_back(firstUv + static_cast<uint32_t>(frame));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        uvs_.push_back(frames[i].uv);
+    }
+
+    clips_.push_back(clip);
+    return static_cast<ClipId>(clips_.size() - 1);
+}
+
+ClipId FlipbookLibrary::AddGridClip(int columns, int rows, int firstCell, int frameCount,
+                                    float frameDuration, FlipbookLoop loop) {
+    if (columns <= 0 || rows <= 0 || firstCell < 0 || frameCount <= 0 ||
+        firstCell + frameCount > columns * rows) {
+        return kInvalidClip;
+    }
+    const float cellW = 1.0f / columns;
+    const float cellH = 1.0f / rows;
+    std::vector<FlipbookFrame> frames(frameCount);
+    for (int i = 0; i < frameCount; ++i) {
+        const int cell = firstCell + i;
+        FlipbookFrame& f = frames[i];
+        f.uv.u0 = (cell % columns) * cellW;
+        f.uv.v0 = (cell / columns) * cellH;
+        f.uv.u1 = f.uv.u0 + cellW;
+        f.uv.v1 = f.uv.v0 + cellH;
+        f.duration = frameDuration;
+    }
+    return AddClip(frames.data(), frames.size(), loop);
+}
+
+uint32_t FlipbookAnimator::Add(ClipId clip, float speed, float startTime) {
+    if (clip >= library_->clips_.size()) {
+        return kInvalidIndex;
+    }
+    const uint32_t index = static_cast<uint32_t>(time_.size());
+    time_.push_back(0.0f);
+    speed_.push_back(speed);
+    clip_.push_back(kInvalidClip);
+    period_.push_back(0.0f);
+    invPeriod_.push_back(0.0f);
+    length_.push_back(0.0f);
+    fold_.push_back(0.0f);
+    slotsPerSecond_.push_back(0.0f);
+    lastSlot_.push_back(0);
+    firstSlot_.push_back(0);
+    uvs_.emplace_back();
+    Play(index, clip, startTime);
+    return index;
+}
+
+void FlipbookAnimator::Remove(uint32_t index) {
+    if (index >= time_.size()) {
+        return;
+    }
+    auto swapPop = [index](auto& v) {
+        v[index] = v.back();
+        v.pop_back();
+    };
+    swapPop(time_);
+    swapPop(speed_);
+    swapPop(clip_);
+    swapPop(period_);
+    swapPop(invPeriod_);
+    swapPop(length_);
+    swapPop(fold_);
+    swapPop(slotsPerSecond_);
+    swapPop(lastSlot_);
+    swapPop(firstSlot_);
+    swapPop(uvs_);
+}
+
+void FlipbookAnimator::Clear() {
+    time_.clear();
+    speed_.clear();
+    clip_.clear();
+    period_.clear();
+    invPeriod_.clear();
+    length_.clear();
+    fold_.clear();
+    slotsPerSecond_.clear();
+    lastSlot_.clear();
+    firstSlot_.clear();
+    uvs_.clear();
+}
+
+void FlipbookAnimator::Reserve(size_t count) {
+    time_.reserve(count);
+    speed_.reserve(count);
+    clip_.reserve(count);
+    period_.reserve(count);
+    invPeriod_.reserve(count);
+    length_.reserve(count);
+    fold_.reserve(count);
+    slotsPerSecond_.reserve(count);
+    lastSlot_.reserve(count);
+    firstSlot_.reserve(count);
+    uvs_.reserve(count);
+}
+
+bool FlipbookAnimator::Play(uint32_t index, ClipId clip, float startTime) {
+    if (index >= time_.size() || clip >= library_->clips_.size()) {
+        return false;
+    }
+    const FlipbookLibrary::Clip& c = library_->clips_[clip];
+    const bool pingPong = c.loop == FlipbookLoop::PingPong;
+    clip_[index] = clip;
+    length_[index] = c.length;
+    period_[index] = pingPong ? c.length * 2.0f : c.length;
+    invPeriod_[index] = c.loop == FlipbookLoop::Once ? 0.0f : 1.0f / period_[index];
+    fold_[index] = pingPong ? 1.0f : 0.0f;
+    slotsPerSecond_[index] = c.slotsPerSecond;
+    lastSlot_[index] = static_cast<int32_t>(c.slotCount - 1);
+    firstSlot_[index] = c.firstSlot;
+    time_[index] = std::min(std::max(startTime, 0.0f), period_[index]);
+    uvs_[index] = library_->uvs_[library_->slotUv_[c.firstSlot]];
+    return true;
+}
+
+bool FlipbookAnimator::Finished(uint32_t index) const {
+    if (library_->clips_[clip_[index]].loop != FlipbookLoop::Once) {
+        return false;
+    }
+    return speed_[index] >= 0.0f ? time_[index] >= length_[index] : time_[index] <= 0.0f;
+}
+
+void FlipbookAnimator::Sample(float dt) {
+    const size_t count = time_.size();
+    float* time = time_.data();
+    const float* speed = speed_.data();
+    const float* period = period_.data();
+    const float* invPeriod = invPeriod_.data();
+    const float* length = length_.data();
+    const float* fold = fold_.data();
+    const float* slotsPerSecond = slotsPerSecond_.data();
+    const int32_t* lastSlot = lastSlot_.data();
+    const uint32_t* firstSlot = firstSlot_.data();
+    const uint32_t* slotUv = library_->slotUv_.data();
+    const UvRect* clipUvs = library_->uvs_.data();
+    UvRect* out = uvs_.data();
+
+    uint32_t slots[kSampleBlock];
+    for (size_t base = 0; base < count; base += kSampleBlock) {
+        const size_t n = std::min(kSampleBlock, count - base);
+
+        // Straight-line arithmetic over the SoA arrays; the loop mode is
+        // folded into period/invPeriod/fold, so there is nothing to branch
+        // on and the compiler can vectorize it.
+        for (size_t i = 0; i < n; ++i) {
+            const size_t k = base + i;
+            float t = time[k] + dt * speed[k];
+            const float wraps = t * invPeriod[k];
+            int w = static_cast<int>(wraps);
+            w -= static_cast<int>(wraps < static_cast<float>(w)); // floor
+            t -= period[k] * static_cast<float>(w);
+            t = std::min(std::max(t, 0.0f), period[k]);
+            time[k] = t;
+            // Ping-pong plays [L, 2L) backwards: L - |t - L|.
+            const float len = length[k];
+            const float local = t + fold[k] * ((len - std::fabs(t - len)) - t);
+            const int slot = std::min(static_cast<int>(local * slotsPerSecond[k]), lastSlot[k]);
+            slots[i] = firstSlot[k] + static_cast<uint32_t>(slot);
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            out[base + i] = clipUvs[slotUv[slots[i]]];
+        }
+    }
+}
+
+void FlipbookAnimator::ApplyUvs(SpriteQuad* quads, size_t count) const {
+    count = std::min(count, uvs_.size());
+    for (size_t i = 0; i < count; ++i) {
+        quads[i].u0 = uvs_[i].u0;
+        quads[i].v0 = uvs_[i].v0;
+        quads[i].u1 = uvs_[i].u1;
+        quads[i].v1 = uvs_[i].v1;
+    }
+}
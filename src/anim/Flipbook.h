@@ -0,0 +1,111 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct SpriteQuad;
+
+struct UvRect {
+    float u0 = 0.0f;
+    float v0 = 0.0f;
+    float u1 = 1.0f;
+    float v1 = 1.0f;
+};
+
+struct FlipbookFrame {
+    UvRect uv;
+    float duration = 0.1f; // seconds
+};
+
+enum class FlipbookLoop : uint8_t {
+    Once,     // holds the last frame
+    Loop,
+    PingPong, // forward, then backward
+};
+
+using ClipId = uint32_t;
+constexpr ClipId kInvalidClip = 0xFFFFFFFFu;
+
+// Clip definitions shared by every instance. Each clip's timeline is
+// quantized into equal slots, and a slot table maps a slot straight to its
+// frame's UV rect, so sampling is a multiply and two loads whatever the
+// frame count. Clips with uniform frame durations get exactly one slot per
+// frame; otherwise slots are a quarter of the shortest frame, so a frame
+// change lands at most that late.
+class FlipbookLibrary {
+public:
+    ClipId AddClip(const FlipbookFrame* frames, size_t count, FlipbookLoop loop);
+    // Frames read row by row from a grid of equally sized cells in the atlas.
+    ClipId AddGridClip(int columns, int rows, int firstCell, int frameCount,
+                       float frameDuration, FlipbookLoop loop);
+
+    size_t ClipCount() const { return clips_.size(); }
+    float Length(ClipId clip) const { return clips_[clip].length; }
+
+private:
+    friend class FlipbookAnimator;
+
+    struct Clip {
+        uint32_t firstSlot;
+        uint32_t slotCount;
+        float length;
+        float slotsPerSecond;
+        FlipbookLoop loop;
+    };
+
+    std::vector<Clip> clips_;
+    std::vector<uint32_t> slotUv_; // slot -> index into uvs_
+    std::vector<UvRect> uvs_;
+};
+
+// Playback state for many sprites, one structure-of-arrays slot per
+// instance. Play() copies the few clip constants the sampler needs into the
+// instance's slots, so Sample() streams through contiguous arrays without
+// branching on the loop mode or looking up the clip.
+//
+// Instances are dense: Remove moves the last instance into the freed index.
+class FlipbookAnimator {
+public:
+    explicit FlipbookAnimator(const FlipbookLibrary& library) : library_(&library) {}
+
+    static constexpr uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    // kInvalidIndex when the clip is unknown.
+    uint32_t Add(ClipId clip, float speed = 1.0f, float startTime = 0.0f);
+    void Remove(uint32_t index); // swap-with-last
+    void Clear();
+    void Reserve(size_t count);
+
+    bool Play(uint32_t index, ClipId clip, float startTime = 0.0f); // false: unknown clip, unchanged
+    void SetSpeed(uint32_t index, float speed) { speed_[index] = speed; } // 0 pauses, < 0 reverses
+    float Time(uint32_t index) const { return time_[index]; }
+    bool Finished(uint32_t index) const; // Once clips that reached their end
+
+    // Advances every instance by dt and writes its current UV rect.
+    void Sample(float dt);
+
+    size_t Size() const { return time_.size(); }
+    const UvRect* Uvs() const { return uvs_.data(); }
+    // Copies the UV rects into the first min(count, Size()) quads, leaving
+    // everything else about them alone.
+    void ApplyUvs(SpriteQuad* quads, size_t count) const;
+
+private:
+    const FlipbookLibrary* library_;
+
+    // Per-instance state.
+    std::vector<float> time_;   // [0, period]
+    std::vector<float> speed_;
+    std::vector<ClipId> clip_;
+
+    // Per-instance copies of clip constants, laid out for the sampler.
+    std::vector<float> period_;          // length, or twice it for ping-pong
+    std::vector<float> invPeriod_;       // 0 for Once: never wraps
+    std::vector<float> length_;
+    std::vector<float> fold_;            // 1 for ping-pong, else 0
+    std::vector<float> slotsPerSecond_;
+    std::vector<int32_t> lastSlot_;
+    std::vector<uint32_t> firstSlot_;
+
+    std::vector<UvRect> uvs_; // output
+};
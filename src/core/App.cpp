@@ -3,24 +3,71 @@
 #include <cmath>
 #include <cstdio>
 
-App::App(const AppConfig& cfg) : cfg_(cfg) {}
+App::App(const AppConfig& cfg) : cfg_(cfg) {
+    playerNode_ = scene_.Create();
+}
 
 void App::Update(float dt) {
     state_.playerX = std::clamp(state_.playerX, 0.0f, (float)cfg_.width - 64.0f);
     state_.playerY = std::clamp(state_.playerY, 0.0f, (float)cfg_.height - 64.0f);
+
+    Transform2D local = scene_.Local(playerNode_);
+    if(local.x != state_.playerX || local.y != state_.playerY) {
+        local.x = state_.playerX;
+        local.y = state_.playerY;
+        scene_.SetLocal(playerNode_, local);
+    }
+    scene_.Update();
+    animator_.Sample(dt);
 }
 
 void App::Render() {
     if(!renderer_) return;
-    renderer_->BeginFrame(0.07f, 0.08f, 0.1f, 1.0f);
+    drawList_.Reset();
+    drawList_.Clear(0.07f, 0.08f, 0.1f, 1.0f);
     const float w = 96.0f;
     const float h = 96.0f;
-    if(hasTexture_ && playerTex_) {
-        renderer_->DrawTexturedQuad(state_.playerX, state_.playerY, w, h, playerTex_);
+    const Affine2D& player = scene_.World(playerNode_);
+    if(hasTexture_ && playerTex_ && playerAnim_ != FlipbookAnimator::kInvalidIndex) {
+        SpriteQuad quad;
+        quad.x = player.tx;
+        quad.y = player.ty;
+        quad.w = w;
+        quad.h = h;
+        const UvRect& uv = animator_.Uvs()[playerAnim_];
+        quad.u0 = uv.u0;
+        quad.v0 = uv.v0;
+        quad.u1 = uv.u1;
+        quad.v1 = uv.v1;
+        drawList_.Sprites(&quad, 1, playerTex_);
+    } else if(hasTexture_ && playerTex_) {
+        drawList_.TexturedQuad(player.tx, player.ty, w, h, playerTex_);
+    } else {
+        drawList_.Quad(player.tx, player.ty, w, h);
+    }
+    text_.Record(drawList_, *renderer_);
+    drawList_.Overlay(overlay_);
+
+    // Nothing changed since the last presented frame: leave it on screen
+    // instead of re-recording and presenting identical GPU work.
+    if(frameValid_ && drawList_.Fingerprint() == prevDrawList_.Fingerprint() &&
+       renderer_->PresentPrevious()) {
+        ++frameStats_.skipped;
+        return;
+    }
+
+    if(frameValid_) {
+        drawList_.Damage(prevDrawList_, (float)cfg_.width, (float)cfg_.height, damage_);
     } else {
-        renderer_->DrawQuad(state_.playerX, state_.playerY, w, h);
+        damage_.assign(1, FrameRect{0.0f, 0.0f, (float)cfg_.width, (float)cfg_.height});
     }
-    renderer_->EndFrame();
+    renderer_->SetDamage(damage_.data(), damage_.size());
+    drawList_.Submit(*renderer_);
+    ++frameStats_.submitted;
+    frameStats_.damageRects = damage_.size();
+
+    std::swap(drawList_, prevDrawList_);
+    frameValid_ = true;
 }
 
 void App::OnKey(bool down, int key) {
@@ -38,4 +85,14 @@ void App::OnKey(bool down, int key) {
 void App::SetPlayerTexture(void* texture) {
     playerTex_ = texture;
     hasTexture_ = texture != nullptr;
+    frameValid_ = false;
+}
+
+void App::SetPlayerClip(ClipId clip) {
+    if(playerAnim_ == FlipbookAnimator::kInvalidIndex) {
+        playerAnim_ = animator_.Add(clip);
+    } else if(!animator_.Play(playerAnim_, clip)) {
+        animator_.Remove(playerAnim_);
+        playerAnim_ = FlipbookAnimator::kInvalidIndex;
+    }
 }
@@ -1,10 +1,21 @@
 #pragma once
 #include <string>
+#include <vector>
+
+#include "../anim/Flipbook.h"
+#include "../render/DrawList.h"
+#include "../render/text/TextRenderer.h"
+#include "../scene/TransformHierarchy.h"
 
 struct AppConfig {
     int width = 1280;
     int height = 720;
     std::string title = "MiniGame2D";
+    bool vsync = true;
+    float targetFps = 0.0f;  // 0 = uncapped (vsync paces the loop when enabled)
+    bool lowLatency = true;  // sample input just before the predicted present
+    std::string fontPath = "assets/font.ttf";
+    float fontSize = 18.0f;  // pixels
 };
 
 struct GameState {
@@ -19,8 +30,41 @@ public:
     virtual void BeginFrame(float r, float g, float b, float a) = 0;
     virtual void DrawQuad(float x, float y, float w, float h) = 0; // colored fallback
     virtual void DrawTexturedQuad(float x, float y, float w, float h, void* texture) = 0;
+    // Any number of quads sharing one texture (null = untextured), drawn
+    // alpha-blended in order.
+    virtual void DrawSprites(const SpriteQuad* quads, size_t count, void* texture) = 0;
     virtual void* LoadTextureFromFile(const char* path) = 0; // returns API texture pointer
+    // RGBA8 texture whose pixels can be replaced later; owned by the renderer.
+    virtual void* CreateTexture(int width, int height, const uint8_t* rgba) = 0;
+    // rgba points at the region's first pixel; rows are pitch bytes apart.
+    virtual void UpdateTexture(void* texture, int x, int y, int width, int height,
+                               const uint8_t* rgba, size_t pitch) = 0;
     virtual void EndFrame() = 0;
+
+    // Called instead of drawing when the frame would be identical to the
+    // last presented one; returns true if that frame stays on screen
+    // without a Present. Backends that cannot keep it return false and get
+    // a full redraw instead. Headless ones have nothing to show and just
+    // return true.
+    virtual bool PresentPrevious() { return false; }
+    // Set before a redraw with what changed since the previous frame, for
+    // backends that can redraw partially. Ignoring it is always correct.
+    virtual void SetDamage(const FrameRect* rects, size_t count) { (void)rects; (void)count; }
+};
+
+// Drawn last, after the scene (e.g. the ImGui layer). The fingerprint must
+// change whenever Draw would produce different output.
+class IFrameOverlay {
+public:
+    virtual ~IFrameOverlay() = default;
+    virtual uint64_t Fingerprint() const = 0;
+    virtual void Draw() = 0;
+};
+
+struct FrameStats {
+    uint64_t submitted = 0;
+    uint64_t skipped = 0;
+    size_t damageRects = 0; // last redrawn frame
 };
 
 class App {
@@ -31,13 +75,38 @@ public:
     void OnKey(bool down, int key);
 
     GameState& State() { return state_; }
+    // Attach objects under PlayerNode() to have them follow the player.
+    TransformHierarchy& Scene() { return scene_; }
+    TransformId PlayerNode() const { return playerNode_; }
+    // Labels drawn here between Update and Render are batched into the frame.
+    TextRenderer& Text() { return text_; }
     void SetRenderer(IRenderer2D* r) { renderer_ = r; }
     void SetPlayerTexture(void* texture);
+    // Plays a clip from Animations() on the player texture (an atlas);
+    // kInvalidClip draws the whole texture again.
+    void SetPlayerClip(ClipId clip);
+    FlipbookLibrary& Animations() { return animations_; }
+    void SetOverlay(IFrameOverlay* overlay) { overlay_ = overlay; }
+    void InvalidateFrame() { frameValid_ = false; }
+    const FrameStats& Stats() const { return frameStats_; }
 
 private:
     AppConfig cfg_;
     GameState state_;
+    TransformHierarchy scene_;
+    TransformId playerNode_ = kInvalidTransform;
     IRenderer2D* renderer_ = nullptr;
     void* playerTex_ = nullptr;
     bool hasTexture_ = false;
+    IFrameOverlay* overlay_ = nullptr;
+    TextRenderer text_;
+    FlipbookLibrary animations_;
+    FlipbookAnimator animator_{animations_};
+    uint32_t playerAnim_ = FlipbookAnimator::kInvalidIndex;
+
+    DrawList drawList_;
+    DrawList prevDrawList_;
+    std::vector<FrameRect> damage_;
+    bool frameValid_ = false;
+    FrameStats frameStats_;
 };
@@ -0,0 +1,33 @@
+#pragma once
+#include <chrono>
+#include <thread>
+
+// Time source for frame pacing. Injected so pacing logic can be driven by a
+// scripted clock instead of wall time.
+class IFrameClock {
+public:
+    virtual ~IFrameClock() = default;
+    virtual double Now() = 0; // seconds, monotonic
+    virtual void SleepUntil(double t) = 0;
+};
+
+class SteadyFrameClock : public IFrameClock {
+public:
+    double Now() override {
+        using namespace std::chrono;
+        return duration<double>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    void SleepUntil(double t) override {
+        // OS sleeps overshoot by up to a scheduler quantum, so sleep coarsely
+        // and spin the remainder.
+        const double spinWindow = 0.002;
+        double now = Now();
+        if (t - now > spinWindow) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(t - now - spinWindow));
+        }
+        while (Now() < t) {
+            std::this_thread::yield();
+        }
+    }
+};
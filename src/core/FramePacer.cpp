@@ -0,0 +1,206 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double kEmaAlpha = 0.1;
+
+double Median(std::vector<double>& values) {
+    const size_t mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    return values[mid];
+}
+
+} // namespace
+
+FramePacer::FramePacer(IFrameClock& clock, const FramePacerConfig& cfg) : clock_(clock) {
+    SetConfig(cfg);
+    latency_.reserve(kLatencyHistory);
+}
+
+void FramePacer::SetConfig(const FramePacerConfig& cfg) {
+    cfg_ = cfg;
+    cfg_.smoothingFrames = std::max(cfg_.smoothingFrames, 1);
+    dtHistory_.clear();
+    dtNext_ = 0;
+}
+
+double FramePacer::PredictedWork() const {
+    // Mean plus two deviations: being early costs a little latency, being
+    // late costs a whole missed present.
+    return workAvg_ + 2.0 * workDev_;
+}
+
+double FramePacer::NextWakeTime() {
+    if (!presented_) {
+        return 0.0;
+    }
+    if (cfg_.targetHz > 0.0) {
+        // Deadlines sit on a fixed grid so the rate does not drift with the
+        // work estimate or with oversleep. After a stall the grid restarts
+        // from the last present instead of bursting to catch up: a plain
+        // limiter starts the next frame at once, a present deadline needs a
+        // whole period of room.
+        const double period = 1.0 / cfg_.targetHz;
+        deadline_ += period;
+        if (deadline_ < lastPresent_) {
+            deadline_ = lastPresent_ + (cfg_.lowLatency ? period : 0.0);
+        }
+    } else if (presentInterval_ > 0.0) {
+        // No limiter: Present returns right after the vblank it waited for.
+        deadline_ = lastPresent_ + presentInterval_;
+    } else {
+        return 0.0;
+    }
+
+    if (cfg_.lowLatency) {
+        return deadline_ - PredictedWork() - cfg_.latencyMargin;
+    }
+    if (cfg_.targetHz > 0.0) {
+        // Wake on the grid itself; stepping from the last frame start would
+        // add every oversleep to the period.
+        return deadline_;
+    }
+    return 0.0;
+}
+
+float FramePacer::BeginFrame() {
+    const double wake = NextWakeTime();
+    if (wake > clock_.Now()) {
+        clock_.SleepUntil(wake);
+    }
+
+    const double start = clock_.Now();
+    if (started_) {
+        rawDt_ = static_cast<float>(start - frameStart_);
+        smoothedDt_ = FilterDt(start - frameStart_);
+    }
+    frameStart_ = start;
+    inputSampled_ = start;
+    presentBegin_ = -1.0;
+    started_ = true;
+    return smoothedDt_;
+}
+
+float FramePacer::FilterDt(double raw) {
+    raw = std::clamp(raw, 0.0, cfg_.maxDt);
+
+    const size_t window = static_cast<size_t>(cfg_.smoothingFrames);
+    if (dtHistory_.size() < window) {
+        dtHistory_.push_back(raw);
+    } else {
+        dtHistory_[dtNext_] = raw;
+    }
+    dtNext_ = (dtNext_ + 1) % window;
+
+    // Outliers are judged against the median, which a single hitch cannot
+    // move; a sustained rate change shifts the median within half a window
+    // and is then accepted as the new normal.
+    scratch_.assign(dtHistory_.begin(), dtHistory_.end());
+    const double median = Median(scratch_);
+    const double limit = median * cfg_.outlierFactor;
+    if (dtHistory_.size() >= 3 && raw > limit) {
+        ++outliers_;
+    }
+
+    double sum = 0.0;
+    size_t count = 0;
+    for (double v : dtHistory_) {
+        if (dtHistory_.size() < 3 || v <= limit) {
+            sum += v;
+            ++count;
+        }
+    }
+    return count ? static_cast<float>(sum / count) : static_cast<float>(median);
+}
+
+void FramePacer::MarkInputSampled() {
+    inputSampled_ = clock_.Now();
+}
+
+void FramePacer::MarkPresentBegin() {
+    presentBegin_ = clock_.Now();
+}
+
+void FramePacer::EndFrame() {
+    if (!started_) {
+        return;
+    }
+    const double now = clock_.Now();
+    const double workEnd = presentBegin_ >= 0.0 ? presentBegin_ : now;
+    double work = std::max(workEnd - inputSampled_, 0.0);
+
+    if (workAvg_ == 0.0) {
+        workAvg_ = work;
+    } else {
+        // A single hitch should not make the next second of frames wake early;
+        // genuine growth still gets through, doubling per sample at most.
+        work = std::min(work, std::max(PredictedWork() * 2.0, 0.001));
+        workDev_ += (std::fabs(work - workAvg_) - workDev_) * kEmaAlpha;
+        workAvg_ += (work - workAvg_) * kEmaAlpha;
+    }
+
+    if (presented_) {
+        const double interval = now - lastPresent_;
+        presentInterval_ = presentInterval_ == 0.0
+                               ? interval
+                               : presentInterval_ + (interval - presentInterval_) * kEmaAlpha;
+    }
+
+    const double latency = now - inputSampled_;
+    if (latency_.size() < kLatencyHistory) {
+        latency_.push_back(latency);
+    } else {
+        latency_[latencyNext_] = latency;
+    }
+    latencyNext_ = (latencyNext_ + 1) % kLatencyHistory;
+
+    if (!presented_) {
+        // The first frame anchors the grid: at its present for a present
+        // deadline, at its start for a plain limiter, which wakes on the grid.
+        deadline_ = cfg_.targetHz > 0.0 && !cfg_.lowLatency ? frameStart_ : now;
+    }
+    lastPresent_ = now;
+    presented_ = true;
+}
+
+void FramePacer::SkipFrame() {
+    if (!presented_ || cfg_.targetHz > 0.0 || presentInterval_ <= 0.0) {
+        return; // with a limiter, BeginFrame already sleeps to the next deadline
+    }
+    // Vsync paces the loop by blocking in Present. With nothing presented,
+    // wait out the vblank that Present would have waited for instead of
+    // spinning. The work, latency and interval estimates only learn from
+    // real presents.
+    const double now = clock_.Now();
+    const double vblank = lastPresent_ + presentInterval_;
+    if (vblank > now) {
+        clock_.SleepUntil(vblank);
+    }
+    lastPresent_ = std::max(vblank, now);
+}
+
+LatencyStats FramePacer::Latency() const {
+    LatencyStats stats;
+    stats.samples = latency_.size();
+    if (latency_.empty()) {
+        return stats;
+    }
+    const size_t last = (latencyNext_ + kLatencyHistory - 1) % kLatencyHistory;
+    stats.lastMs = latency_[std::min(last, latency_.size() - 1)] * 1000.0;
+
+    scratch_.assign(latency_.begin(), latency_.end());
+    std::sort(scratch_.begin(), scratch_.end());
+    double sum = 0.0;
+    for (double v : scratch_) {
+        sum += v;
+    }
+    stats.avgMs = sum / scratch_.size() * 1000.0;
+    stats.minMs = scratch_.front() * 1000.0;
+    stats.maxMs = scratch_.back() * 1000.0;
+    const size_t p99 = std::min(scratch_.size() - 1, (scratch_.size() * 99) / 100);
+    stats.p99Ms = scratch_[p99] * 1000.0;
+    return stats;
+}
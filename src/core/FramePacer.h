@@ -0,0 +1,89 @@
+#pragma once
+#include "FrameClock.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct FramePacerConfig {
+    double targetHz = 0.0;       // 0 = no limiter, let Present/vsync pace the loop
+    int smoothingFrames = 8;
+    double outlierFactor = 3.0;  // dt above median * factor is a hitch, not motion
+    double maxDt = 0.1;
+    bool lowLatency = false;     // delay input/simulation until just before present
+    double latencyMargin = 0.001;
+};
+
+struct LatencyStats {
+    size_t samples = 0;
+    double lastMs = 0.0;
+    double avgMs = 0.0;
+    double minMs = 0.0;
+    double maxMs = 0.0;
+    double p99Ms = 0.0;
+};
+
+// Drives the main loop:
+//
+//   float dt = pacer.BeginFrame();   // may sleep; sample input right after
+//   ...update, render...
+//   pacer.MarkPresentBegin();        // right before Present
+//   Present
+//   pacer.EndFrame();                // right after Present returns
+//
+// A frame that presents nothing calls SkipFrame() instead of the last three.
+//
+// In low-latency mode BeginFrame sleeps until the predicted present deadline
+// minus the predicted CPU work, so input is as fresh as possible when the
+// frame reaches the screen.
+class FramePacer {
+public:
+    explicit FramePacer(IFrameClock& clock, const FramePacerConfig& cfg = FramePacerConfig());
+
+    float BeginFrame();
+    void MarkInputSampled(); // optional, if input is sampled later than BeginFrame returns
+    void MarkPresentBegin(); // optional, keeps time blocked in Present out of the work estimate
+    void EndFrame();
+    void SkipFrame(); // nothing was presented this frame
+
+    void SetConfig(const FramePacerConfig& cfg);
+    const FramePacerConfig& Config() const { return cfg_; }
+
+    float RawDt() const { return rawDt_; }
+    float SmoothedDt() const { return smoothedDt_; }
+    double PredictedWork() const;
+    double PresentInterval() const { return presentInterval_; }
+    uint64_t OutliersRejected() const { return outliers_; }
+    LatencyStats Latency() const;
+
+private:
+    double NextWakeTime();
+    float FilterDt(double raw);
+
+    static constexpr size_t kLatencyHistory = 240;
+
+    IFrameClock& clock_;
+    FramePacerConfig cfg_;
+
+    bool started_ = false;
+    bool presented_ = false;
+    double frameStart_ = 0.0;
+    double inputSampled_ = 0.0;
+    double presentBegin_ = -1.0;
+    double lastPresent_ = 0.0;
+    double deadline_ = 0.0;
+
+    double workAvg_ = 0.0;   // EMA of input sample -> present call (CPU work)
+    double workDev_ = 0.0;   // EMA of absolute deviation
+    double presentInterval_ = 0.0;
+
+    float rawDt_ = 0.0f;
+    float smoothedDt_ = 0.0f;
+    uint64_t outliers_ = 0;
+    std::vector<double> dtHistory_;
+    size_t dtNext_ = 0;
+    mutable std::vector<double> scratch_;
+
+    std::vector<double> latency_;
+    size_t latencyNext_ = 0;
+};
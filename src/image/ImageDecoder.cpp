@@ -0,0 +1,83 @@
+#include "ImageDecoder.h"
+#include "PngDecoder.h"
+#include "QoiDecoder.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+ImageFormat Detect(const uint8_t* data, size_t size) {
+    static const uint8_t kPngMagic[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (size >= 8 && std::memcmp(data, kPngMagic, 8) == 0) {
+        return ImageFormat::Png;
+    }
+    if (size >= 4 && std::memcmp(data, "qoif", 4) == 0) {
+        return ImageFormat::Qoi;
+    }
+    return ImageFormat::Unknown;
+}
+
+} // namespace
+
+bool ReadImageInfo(const uint8_t* data, size_t size, ImageInfo& info) {
+    info = ImageInfo();
+    if (!data) {
+        return false;
+    }
+    bool ok = false;
+    info.format = Detect(data, size);
+    switch (info.format) {
+        case ImageFormat::Qoi:
+            ok = QoiReadInfo(data, size, info.width, info.height);
+            break;
+        case ImageFormat::Png:
+            ok = PngReadInfo(data, size, info.width, info.height);
+            break;
+        default:
+            break;
+    }
+    return ok && info.width > 0 && info.height > 0 &&
+           info.width <= kMaxImageDimension && info.height <= kMaxImageDimension;
+}
+
+bool DecodeImage(const uint8_t* data, size_t size, uint8_t* dst, size_t dstPitch) {
+    ImageInfo info;
+    if (!dst || !ReadImageInfo(data, size, info) || dstPitch < static_cast<size_t>(info.width) * 4) {
+        return false;
+    }
+    switch (info.format) {
+        case ImageFormat::Qoi:
+            return QoiDecode(data, size, dst, dstPitch);
+        case ImageFormat::Png:
+            return PngDecode(data, size, dst, dstPitch);
+        default:
+            return false;
+    }
+}
+
+bool DecodeImage(const uint8_t* data, size_t size, ImageInfo& info, std::vector<uint8_t>& rgba) {
+    if (!ReadImageInfo(data, size, info)) {
+        return false;
+    }
+    const size_t pitch = static_cast<size_t>(info.width) * 4;
+    rgba.resize(pitch * info.height);
+    return DecodeImage(data, size, rgba.data(), pitch);
+}
+
+bool ReadFileBytes(const char* path, std::vector<uint8_t>& out) {
+    out.clear();
+    FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    bool ok = std::fseek(f, 0, SEEK_END) == 0;
+    const long length = ok ? std::ftell(f) : -1;
+    ok = ok && length >= 0 && std::fseek(f, 0, SEEK_SET) == 0;
+    if (ok) {
+        out.resize(static_cast<size_t>(length));
+        ok = length == 0 || std::fread(out.data(), 1, out.size(), f) == out.size();
+    }
+    std::fclose(f);
+    return ok;
+}
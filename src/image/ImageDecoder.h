@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class ImageFormat {
+    Unknown,
+    Qoi,
+    Png,
+};
+
+struct ImageInfo {
+    int width = 0;
+    int height = 0;
+    ImageFormat format = ImageFormat::Unknown;
+};
+
+constexpr int kMaxImageDimension = 16384;
+
+// Portable RGBA8 decoding for QOI and PNG. Nothing here touches global state,
+// so any thread may decode. Unsupported inputs (other formats, interlaced
+// PNG) fail cleanly so a caller can fall back to a platform codec.
+bool ReadImageInfo(const uint8_t* data, size_t size, ImageInfo& info);
+
+// Writes straight into caller memory, e.g. a mapped upload buffer: row y
+// starts at dst + y * dstPitch, and dstPitch must be at least width * 4.
+// dst is only ever written, never read, so write-combined memory is fine.
+bool DecodeImage(const uint8_t* data, size_t size, uint8_t* dst, size_t dstPitch);
+
+bool DecodeImage(const uint8_t* data, size_t size, ImageInfo& info, std::vector<uint8_t>& rgba);
+
+bool ReadFileBytes(const char* path, std::vector<uint8_t>& out);
@@ -0,0 +1,344 @@
+#include "Inflate.h"
+
+#include <cstring>
+
+namespace {
+
+constexpr int kFastBits = 9;
+constexpr int kFastMask = (1 << kFastBits) - 1;
+
+// Canonical Huffman decoder: codes up to kFastBits long resolve with one
+// table lookup, longer ones by a short scan over code lengths.
+struct Huffman {
+    uint16_t fast[1 << kFastBits];
+    uint16_t firstCode[16];
+    int maxCode[17];
+    uint16_t firstSymbol[16];
+    uint8_t size[288];
+    uint16_t value[288];
+};
+
+int BitReverse16(int n) {
+    n = ((n & 0xAAAA) >> 1) | ((n & 0x5555) << 1);
+    n = ((n & 0xCCCC) >> 2) | ((n & 0x3333) << 2);
+    n = ((n & 0xF0F0) >> 4) | ((n & 0x0F0F) << 4);
+    n = ((n & 0xFF00) >> 8) | ((n & 0x00FF) << 8);
+    return n;
+}
+
+int BitReverse(int v, int bits) {
+    return BitReverse16(v) >> (16 - bits);
+}
+
+bool BuildHuffman(Huffman& z, const uint8_t* lengths, int count) {
+    int sizes[17] = {};
+    int nextCode[16];
+    std::memset(z.fast, 0, sizeof(z.fast));
+    for (int i = 0; i < count; ++i) {
+        ++sizes[lengths[i]];
+    }
+    sizes[0] = 0;
+    for (int i = 1; i < 16; ++i) {
+        if (sizes[i] > (1 << i)) {
+            return false;
+        }
+    }
+    int code = 0;
+    int k = 0;
+    for (int i = 1; i < 16; ++i) {
+        nextCode[i] = code;
+        z.firstCode[i] = static_cast<uint16_t>(code);
+        z.firstSymbol[i] = static_cast<uint16_t>(k);
+        code += sizes[i];
+        if (sizes[i] && code - 1 >= (1 << i)) {
+            return false; // over-subscribed
+        }
+        z.maxCode[i] = code << (16 - i);
+        code <<= 1;
+        k += sizes[i];
+    }
+    z.maxCode[16] = 0x10000;
+    for (int i = 0; i < count; ++i) {
+        const int s = lengths[i];
+        if (!s) {
+            continue;
+        }
+        const int c = nextCode[s] - z.firstCode[s] + z.firstSymbol[s];
+        z.size[c] = static_cast<uint8_t>(s);
+        z.value[c] = static_cast<uint16_t>(i);
+        if (s <= kFastBits) {
+            const uint16_t fastValue = static_cast<uint16_t>((s << 9) | i);
+            for (int j = BitReverse(nextCode[s], s); j < (1 << kFastBits); j += (1 << s)) {
+                z.fast[j] = fastValue;
+            }
+        }
+        ++nextCode[s];
+    }
+    return true;
+}
+
+class Inflater {
+public:
+    Inflater(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+        : in_(src), inEnd_(src + srcSize), out_(dst), outStart_(dst), outEnd_(dst + dstSize) {}
+
+    bool Run();
+    bool Finished() const { return out_ == outEnd_; }
+
+private:
+    void Fill() {
+        while (bitCount_ <= 56) {
+            // Reading past the end yields zeros; overrun_ catches streams
+            // that actually consume them.
+            uint64_t byte = 0;
+            if (in_ < inEnd_) {
+                byte = *in_++;
+            } else {
+                ++overrun_;
+            }
+            bits_ |= byte << bitCount_;
+            bitCount_ += 8;
+        }
+    }
+
+    uint32_t Bits(int n) {
+        if (bitCount_ < n) {
+            Fill();
+        }
+        const uint32_t v = static_cast<uint32_t>(bits_ & ((1ull << n) - 1));
+        bits_ >>= n;
+        bitCount_ -= n;
+        return v;
+    }
+
+    int Decode(const Huffman& z) {
+        if (bitCount_ < 16) {
+            Fill();
+        }
+        const int f = z.fast[bits_ & kFastMask];
+        if (f) {
+            const int s = f >> 9;
+            bits_ >>= s;
+            bitCount_ -= s;
+            return f & 511;
+        }
+        const int k = BitReverse16(static_cast<int>(bits_ & 0xFFFF));
+        int s = kFastBits + 1;
+        while (k >= z.maxCode[s]) {
+            ++s;
+        }
+        if (s >= 16) {
+            return -1;
+        }
+        const int b = (k >> (16 - s)) - z.firstCode[s] + z.firstSymbol[s];
+        if (b >= 288 || z.size[b] != s) {
+            return -1;
+        }
+        bits_ >>= s;
+        bitCount_ -= s;
+        return z.value[b];
+    }
+
+    bool Stored();
+    bool Codes(const Huffman& lit, const Huffman& dist);
+    bool DynamicTables(Huffman& lit, Huffman& dist);
+    bool FixedTables(Huffman& lit, Huffman& dist);
+
+    const uint8_t* in_;
+    const uint8_t* inEnd_;
+    uint8_t* out_;
+    uint8_t* outStart_;
+    uint8_t* outEnd_;
+    uint64_t bits_ = 0;
+    int bitCount_ = 0;
+    int overrun_ = 0;
+};
+
+const uint16_t kLengthBase[31] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258, 0, 0};
+const uint8_t kLengthExtra[31] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0, 0, 0};
+const uint16_t kDistBase[32] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                8193, 12289, 16385, 24577, 0, 0};
+const uint8_t kDistExtra[32] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 0, 0};
+const uint8_t kCodeLengthOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+bool Inflater::Stored() {
+    // Drop to the byte boundary and give whole buffered bytes back to the
+    // input, so the block can be copied straight from the source.
+    Bits(bitCount_ & 7);
+    const int buffered = bitCount_ / 8 - overrun_;
+    if (buffered < 0) {
+        return false;
+    }
+    in_ -= buffered;
+    bits_ = 0;
+    bitCount_ = 0;
+    overrun_ = 0;
+
+    if (inEnd_ - in_ < 4) {
+        return false;
+    }
+    const size_t len = in_[0] | (in_[1] << 8);
+    const size_t nlen = in_[2] | (in_[3] << 8);
+    in_ += 4;
+    if (len != (~nlen & 0xFFFF)) {
+        return false;
+    }
+    if (static_cast<size_t>(inEnd_ - in_) < len || static_cast<size_t>(outEnd_ - out_) < len) {
+        return false;
+    }
+    std::memcpy(out_, in_, len);
+    in_ += len;
+    out_ += len;
+    return true;
+}
+
+bool Inflater::Codes(const Huffman& lit, const Huffman& dist) {
+    for (;;) {
+        int sym = Decode(lit);
+        if (sym < 256) {
+            if (sym < 0 || out_ >= outEnd_) {
+                return false;
+            }
+            *out_++ = static_cast<uint8_t>(sym);
+            continue;
+        }
+        if (sym == 256) {
+            return bitCount_ >= overrun_ * 8; // padding zeros must stay unread
+        }
+        sym -= 257;
+        if (sym >= 29) {
+            return false;
+        }
+        size_t len = kLengthBase[sym];
+        if (kLengthExtra[sym]) {
+            len += Bits(kLengthExtra[sym]);
+        }
+        const int dsym = Decode(dist);
+        if (dsym < 0 || dsym >= 30) {
+            return false;
+        }
+        size_t d = kDistBase[dsym];
+        if (kDistExtra[dsym]) {
+            d += Bits(kDistExtra[dsym]);
+        }
+        if (static_cast<size_t>(out_ - outStart_) < d || static_cast<size_t>(outEnd_ - out_) < len) {
+            return false;
+        }
+        const uint8_t* from = out_ - d;
+        if (d >= len) {
+            std::memcpy(out_, from, len);
+            out_ += len;
+        } else {
+            // Overlapping copy repeats the last d bytes; must go forward bytewise.
+            while (len--) {
+                *out_++ = *from++;
+            }
+        }
+    }
+}
+
+bool Inflater::DynamicTables(Huffman& lit, Huffman& dist) {
+    const int hlit = static_cast<int>(Bits(5)) + 257;
+    const int hdist = static_cast<int>(Bits(5)) + 1;
+    const int hclen = static_cast<int>(Bits(4)) + 4;
+    if (hlit > 286 || hdist > 30) {
+        return false; // codes 286/287 and 30/31 never occur in valid data
+    }
+
+    uint8_t codeLengthSizes[19] = {};
+    for (int i = 0; i < hclen; ++i) {
+        codeLengthSizes[kCodeLengthOrder[i]] = static_cast<uint8_t>(Bits(3));
+    }
+    Huffman codeLengths;
+    if (!BuildHuffman(codeLengths, codeLengthSizes, 19)) {
+        return false;
+    }
+
+    uint8_t lengths[286 + 30];
+    const int total = hlit + hdist;
+    int n = 0;
+    while (n < total) {
+        const int c = Decode(codeLengths);
+        if (c < 0 || c >= 19) {
+            return false;
+        }
+        if (c < 16) {
+            lengths[n++] = static_cast<uint8_t>(c);
+            continue;
+        }
+        uint8_t fill = 0;
+        int repeat = 0;
+        if (c == 16) {
+            if (n == 0) {
+                return false;
+            }
+            repeat = static_cast<int>(Bits(2)) + 3;
+            fill = lengths[n - 1];
+        } else if (c == 17) {
+            repeat = static_cast<int>(Bits(3)) + 3;
+        } else {
+            repeat = static_cast<int>(Bits(7)) + 11;
+        }
+        if (total - n < repeat) {
+            return false;
+        }
+        std::memset(lengths + n, fill, repeat);
+        n += repeat;
+    }
+    return BuildHuffman(lit, lengths, hlit) && BuildHuffman(dist, lengths + hlit, hdist);
+}
+
+bool Inflater::FixedTables(Huffman& lit, Huffman& dist) {
+    uint8_t lengths[288];
+    int i = 0;
+    for (; i <= 143; ++i) lengths[i] = 8;
+    for (; i <= 255; ++i) lengths[i] = 9;
+    for (; i <= 279; ++i) lengths[i] = 7;
+    for (; i <= 287; ++i) lengths[i] = 8;
+    uint8_t distLengths[32];
+    std::memset(distLengths, 5, sizeof(distLengths));
+    return BuildHuffman(lit, lengths, 288) && BuildHuffman(dist, distLengths, 32);
+}
+
+bool Inflater::Run() {
+    if (inEnd_ - in_ < 2) {
+        return false;
+    }
+    const int cmf = in_[0];
+    const int flg = in_[1];
+    in_ += 2;
+    if ((cmf * 256 + flg) % 31 != 0 || (cmf & 15) != 8 || (flg & 32) != 0) {
+        return false; // not deflate, or needs a preset dictionary
+    }
+
+    Huffman lit;
+    Huffman dist;
+    bool final = false;
+    while (!final) {
+        final = Bits(1) != 0;
+        const uint32_t type = Bits(2);
+        bool ok = false;
+        if (type == 0) {
+            ok = Stored();
+        } else if (type == 1) {
+            ok = FixedTables(lit, dist) && Codes(lit, dist);
+        } else if (type == 2) {
+            ok = DynamicTables(lit, dist) && Codes(lit, dist);
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool ZlibInflate(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    Inflater inflater(src, srcSize, dst, dstSize);
+    return inflater.Run() && inflater.Finished();
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Decompresses a zlib stream (RFC 1950/1951) into a caller-sized buffer.
+// Returns false on malformed input or if the output would not fit exactly.
+// No global state; safe to call from any thread.
+bool ZlibInflate(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
@@ -0,0 +1,436 @@
+#include "PngDecoder.h"
+#include "ImageDecoder.h"
+#include "Inflate.h"
+
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MINIGAME_PNG_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+enum ColorType : uint8_t {
+    kGray = 0,
+    kRgb = 2,
+    kPalette = 3,
+    kGrayAlpha = 4,
+    kRgba = 6,
+};
+
+enum FilterType : uint8_t {
+    kFilterNone = 0,
+    kFilterSub = 1,
+    kFilterUp = 2,
+    kFilterAvg = 3,
+    kFilterPaeth = 4,
+};
+
+struct PngHeader {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint8_t bitDepth = 0;
+    uint8_t colorType = 0;
+    uint8_t interlace = 0;
+};
+
+uint32_t ReadBE32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+int Channels(uint8_t colorType) {
+    switch (colorType) {
+        case kGray: return 1;
+        case kRgb: return 3;
+        case kPalette: return 1;
+        case kGrayAlpha: return 2;
+        case kRgba: return 4;
+        default: return 0;
+    }
+}
+
+bool ValidDepth(uint8_t colorType, uint8_t depth) {
+    switch (colorType) {
+        case kGray: return depth == 1 || depth == 2 || depth == 4 || depth == 8 || depth == 16;
+        case kPalette: return depth == 1 || depth == 2 || depth == 4 || depth == 8;
+        case kRgb:
+        case kGrayAlpha:
+        case kRgba: return depth == 8 || depth == 16;
+        default: return false;
+    }
+}
+
+bool ParseHeader(const uint8_t* data, size_t size, PngHeader& hdr) {
+    static const uint8_t kMagic[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    // signature + IHDR length/type/13 bytes of data
+    if (size < 8 + 8 + 13 || std::memcmp(data, kMagic, 8) != 0 ||
+        ReadBE32(data + 8) != 13 || std::memcmp(data + 12, "IHDR", 4) != 0) {
+        return false;
+    }
+    const uint8_t* p = data + 16;
+    hdr.width = ReadBE32(p);
+    hdr.height = ReadBE32(p + 4);
+    hdr.bitDepth = p[8];
+    hdr.colorType = p[9];
+    hdr.interlace = p[12];
+    // The dimension cap (also the D3D11 texture limit) bounds the inflate
+    // buffer sized from these fields before any image data is seen.
+    return hdr.width > 0 && hdr.height > 0 && hdr.width <= kMaxImageDimension &&
+           hdr.height <= kMaxImageDimension && ValidDepth(hdr.colorType, hdr.bitDepth) && p[10] == 0 &&
+           p[11] == 0 && hdr.interlace <= 1;
+}
+
+// ---- Unfiltering -----------------------------------------------------------
+// Each routine reconstructs one row. out may alias cur (in-place); prev is the
+// previous reconstructed row, or a zero row for the first one.
+
+void UnfilterScalar(uint8_t filter, uint8_t* out, const uint8_t* cur, const uint8_t* prev,
+                    size_t rowBytes, size_t bpp) {
+    switch (filter) {
+        case kFilterNone:
+            if (out != cur) std::memcpy(out, cur, rowBytes);
+            break;
+        case kFilterSub:
+            for (size_t i = 0; i < bpp; ++i) out[i] = cur[i];
+            for (size_t i = bpp; i < rowBytes; ++i) out[i] = static_cast<uint8_t>(cur[i] + out[i - bpp]);
+            break;
+        case kFilterUp:
+            for (size_t i = 0; i < rowBytes; ++i) out[i] = static_cast<uint8_t>(cur[i] + prev[i]);
+            break;
+        case kFilterAvg:
+            for (size_t i = 0; i < bpp; ++i) out[i] = static_cast<uint8_t>(cur[i] + (prev[i] >> 1));
+            for (size_t i = bpp; i < rowBytes; ++i) {
+                out[i] = static_cast<uint8_t>(cur[i] + ((out[i - bpp] + prev[i]) >> 1));
+            }
+            break;
+        case kFilterPaeth:
+            for (size_t i = 0; i < rowBytes; ++i) {
+                const int a = i >= bpp ? out[i - bpp] : 0;
+                const int b = prev[i];
+                const int c = i >= bpp ? prev[i - bpp] : 0;
+                const int p = a + b - c;
+                const int pa = p > a ? p - a : a - p;
+                const int pb = p > b ? p - b : b - p;
+                const int pc = p > c ? p - c : c - p;
+                const int pred = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+                out[i] = static_cast<uint8_t>(cur[i] + pred);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+#if defined(MINIGAME_PNG_SSE2)
+
+// Sub/Avg/Paeth depend on the pixel to the left, so the SIMD versions work
+// one whole pixel per step (all channels at once) rather than across pixels.
+// Up has no such dependency and is done 16 bytes at a time.
+
+__m128i Load(const uint8_t* p, size_t bpp) {
+    uint32_t v = 0;
+    std::memcpy(&v, p, bpp);
+    return _mm_cvtsi32_si128(static_cast<int>(v));
+}
+
+void Store(uint8_t* p, __m128i v, size_t bpp) {
+    const uint32_t x = static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+    std::memcpy(p, &x, bpp);
+}
+
+void UnfilterUpSse2(uint8_t* out, const uint8_t* cur, const uint8_t* prev, size_t rowBytes) {
+    size_t i = 0;
+    for (; i + 16 <= rowBytes; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_add_epi8(a, b));
+    }
+    for (; i < rowBytes; ++i) {
+        out[i] = static_cast<uint8_t>(cur[i] + prev[i]);
+    }
+}
+
+void UnfilterSubSse2(uint8_t* out, const uint8_t* cur, size_t rowBytes, size_t bpp) {
+    __m128i a = _mm_setzero_si128();
+    for (size_t i = 0; i < rowBytes; i += bpp) {
+        a = _mm_add_epi8(Load(cur + i, bpp), a);
+        Store(out + i, a, bpp);
+    }
+}
+
+void UnfilterAvgSse2(uint8_t* out, const uint8_t* cur, const uint8_t* prev, size_t rowBytes, size_t bpp) {
+    const __m128i one = _mm_set1_epi8(1);
+    __m128i a = _mm_setzero_si128();
+    for (size_t i = 0; i < rowBytes; i += bpp) {
+        const __m128i b = Load(prev + i, bpp);
+        // avg_epu8 rounds up; PNG wants floor((a + b) / 2).
+        const __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+        a = _mm_add_epi8(Load(cur + i, bpp), avg);
+        Store(out + i, a, bpp);
+    }
+}
+
+__m128i Abs16(__m128i x) {
+    return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+}
+
+__m128i Select(__m128i mask, __m128i t, __m128i f) {
+    return _mm_or_si128(_mm_and_si128(mask, t), _mm_andnot_si128(mask, f));
+}
+
+void UnfilterPaethSse2(uint8_t* out, const uint8_t* cur, const uint8_t* prev, size_t rowBytes, size_t bpp) {
+    // Channels are widened to 16 bits so the predictor distances cannot overflow.
+    const __m128i zero = _mm_setzero_si128();
+    __m128i a = zero;
+    __m128i c = zero;
+    for (size_t i = 0; i < rowBytes; i += bpp) {
+        const __m128i b = _mm_unpacklo_epi8(Load(prev + i, bpp), zero);
+        __m128i d = _mm_unpacklo_epi8(Load(cur + i, bpp), zero);
+
+        const __m128i pa = Abs16(_mm_sub_epi16(b, c));          // |p - a|
+        const __m128i pb = Abs16(_mm_sub_epi16(a, c));          // |p - b|
+        const __m128i pc = Abs16(_mm_add_epi16(_mm_sub_epi16(b, c), _mm_sub_epi16(a, c)));
+        const __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+        const __m128i pred = Select(_mm_cmpeq_epi16(smallest, pa), a,
+                                    Select(_mm_cmpeq_epi16(smallest, pb), b, c));
+
+        d = _mm_add_epi8(d, pred); // byte add keeps the mod-256 wrap, high bytes stay 0
+        Store(out + i, _mm_packus_epi16(d, d), bpp);
+        c = b;
+        a = d;
+    }
+}
+
+#endif
+
+void UnfilterRow(uint8_t filter, uint8_t* out, const uint8_t* cur, const uint8_t* prev,
+                 size_t rowBytes, size_t bpp, bool simd) {
+#if defined(MINIGAME_PNG_SSE2)
+    if (!simd) {
+        // fall through to the scalar path
+    } else if (bpp == 3 || bpp == 4) {
+        switch (filter) {
+            case kFilterSub: UnfilterSubSse2(out, cur, rowBytes, bpp); return;
+            case kFilterUp: UnfilterUpSse2(out, cur, prev, rowBytes); return;
+            case kFilterAvg: UnfilterAvgSse2(out, cur, prev, rowBytes, bpp); return;
+            case kFilterPaeth: UnfilterPaethSse2(out, cur, prev, rowBytes, bpp); return;
+            default: break;
+        }
+    } else if (filter == kFilterUp) {
+        UnfilterUpSse2(out, cur, prev, rowBytes);
+        return;
+    }
+#else
+    (void)simd;
+#endif
+    UnfilterScalar(filter, out, cur, prev, rowBytes, bpp);
+}
+
+// ---- Expansion to RGBA8 ----------------------------------------------------
+
+struct Palette {
+    uint8_t rgba[256][4];
+    int size = 0;
+};
+
+struct ColorKey {
+    bool enabled = false;
+    uint16_t r = 0;
+    uint16_t g = 0;
+    uint16_t b = 0;
+};
+
+void ExpandRow(const PngHeader& hdr, const uint8_t* src, uint8_t* dst,
+               const Palette& palette, const ColorKey& key) {
+    const uint32_t w = hdr.width;
+    const int depth = hdr.bitDepth;
+
+    if (depth < 8) {
+        // Packed gray or palette indices, most significant bits first.
+        const int perByte = 8 / depth;
+        const int mask = (1 << depth) - 1;
+        const int scale = hdr.colorType == kGray ? 255 / mask : 1;
+        for (uint32_t x = 0; x < w; ++x) {
+            const int shift = 8 - depth * (1 + static_cast<int>(x % perByte));
+            const int v = (src[x / perByte] >> shift) & mask;
+            uint8_t* o = dst + x * 4;
+            if (hdr.colorType == kPalette) {
+                std::memcpy(o, palette.rgba[v], 4);
+            } else {
+                const uint8_t g = static_cast<uint8_t>(v * scale);
+                o[0] = o[1] = o[2] = g;
+                o[3] = (key.enabled && v == key.r) ? 0 : 255;
+            }
+        }
+        return;
+    }
+
+    // 16-bit samples are big-endian; keep the high byte.
+    const int step = depth / 8;
+    switch (hdr.colorType) {
+        case kRgba:
+            for (uint32_t x = 0; x < w; ++x, src += 4 * step) {
+                dst[x * 4 + 0] = src[0];
+                dst[x * 4 + 1] = src[step];
+                dst[x * 4 + 2] = src[2 * step];
+                dst[x * 4 + 3] = src[3 * step];
+            }
+            break;
+        case kRgb:
+            for (uint32_t x = 0; x < w; ++x, src += 3 * step) {
+                uint8_t* o = dst + x * 4;
+                o[0] = src[0];
+                o[1] = src[step];
+                o[2] = src[2 * step];
+                o[3] = 255;
+                if (key.enabled) {
+                    const uint16_t r = step == 2 ? (src[0] << 8 | src[1]) : src[0];
+                    const uint16_t g = step == 2 ? (src[2] << 8 | src[3]) : src[1];
+                    const uint16_t b = step == 2 ? (src[4] << 8 | src[5]) : src[2];
+                    if (r == key.r && g == key.g && b == key.b) o[3] = 0;
+                }
+            }
+            break;
+        case kGrayAlpha:
+            for (uint32_t x = 0; x < w; ++x, src += 2 * step) {
+                uint8_t* o = dst + x * 4;
+                o[0] = o[1] = o[2] = src[0];
+                o[3] = src[step];
+            }
+            break;
+        case kGray:
+            for (uint32_t x = 0; x < w; ++x, src += step) {
+                uint8_t* o = dst + x * 4;
+                o[0] = o[1] = o[2] = src[0];
+                const uint16_t v = step == 2 ? (src[0] << 8 | src[1]) : src[0];
+                o[3] = (key.enabled && v == key.r) ? 0 : 255;
+            }
+            break;
+        case kPalette:
+            for (uint32_t x = 0; x < w; ++x) {
+                std::memcpy(dst + x * 4, palette.rgba[src[x]], 4);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+} // namespace
+
+bool PngReadInfo(const uint8_t* data, size_t size, int& width, int& height) {
+    PngHeader hdr;
+    if (!ParseHeader(data, size, hdr)) {
+        return false;
+    }
+    width = static_cast<int>(hdr.width);
+    height = static_cast<int>(hdr.height);
+    return true;
+}
+
+bool PngDecode(const uint8_t* data, size_t size, uint8_t* dst, size_t dstPitch, bool simd) {
+    PngHeader hdr;
+    if (!ParseHeader(data, size, hdr) || hdr.interlace != 0) {
+        return false; // Adam7 is left to platform codecs
+    }
+
+    Palette palette;
+    for (int i = 0; i < 256; ++i) {
+        palette.rgba[i][0] = palette.rgba[i][1] = palette.rgba[i][2] = 0;
+        palette.rgba[i][3] = 255;
+    }
+    ColorKey key;
+
+    // Collect chunks. CRCs are not verified: assets are trusted local files
+    // and a corrupt stream still fails in inflate.
+    const uint8_t* idat = nullptr;
+    size_t idatSize = 0;
+    std::vector<uint8_t> idatJoined;
+    size_t pos = 8;
+    bool sawEnd = false;
+    while (!sawEnd && pos + 12 <= size) {
+        const uint32_t len = ReadBE32(data + pos);
+        const uint8_t* type = data + pos + 4;
+        const uint8_t* body = data + pos + 8;
+        if (len > size - pos - 12) {
+            return false;
+        }
+        if (std::memcmp(type, "PLTE", 4) == 0) {
+            if (len % 3 != 0 || len / 3 > 256) return false;
+            palette.size = static_cast<int>(len / 3);
+            for (int i = 0; i < palette.size; ++i) {
+                std::memcpy(palette.rgba[i], body + i * 3, 3);
+            }
+        } else if (std::memcmp(type, "tRNS", 4) == 0) {
+            if (hdr.colorType == kPalette) {
+                for (uint32_t i = 0; i < len && i < 256; ++i) {
+                    palette.rgba[i][3] = body[i];
+                }
+            } else if (hdr.colorType == kGray && len >= 2) {
+                key.enabled = true;
+                key.r = static_cast<uint16_t>(body[0] << 8 | body[1]);
+            } else if (hdr.colorType == kRgb && len >= 6) {
+                key.enabled = true;
+                key.r = static_cast<uint16_t>(body[0] << 8 | body[1]);
+                key.g = static_cast<uint16_t>(body[2] << 8 | body[3]);
+                key.b = static_cast<uint16_t>(body[4] << 8 | body[5]);
+            }
+        } else if (std::memcmp(type, "IDAT", 4) == 0) {
+            // The common single-IDAT case is inflated in place, without a copy.
+            if (!idat && idatJoined.empty()) {
+                idat = body;
+                idatSize = len;
+            } else {
+                if (idat) {
+                    idatJoined.assign(idat, idat + idatSize);
+                    idat = nullptr;
+                }
+                idatJoined.insert(idatJoined.end(), body, body + len);
+            }
+        } else if (std::memcmp(type, "IEND", 4) == 0) {
+            sawEnd = true;
+        }
+        pos += 12 + len;
+    }
+    if (!idatJoined.empty()) {
+        idat = idatJoined.data();
+        idatSize = idatJoined.size();
+    }
+    if (!idat || (hdr.colorType == kPalette && palette.size == 0)) {
+        return false;
+    }
+
+    const size_t bitsPerPixel = static_cast<size_t>(Channels(hdr.colorType)) * hdr.bitDepth;
+    const size_t rowBytes = (hdr.width * bitsPerPixel + 7) / 8;
+    const size_t bpp = bitsPerPixel >= 8 ? bitsPerPixel / 8 : 1;
+    const size_t stride = rowBytes + 1; // leading filter byte
+
+    std::vector<uint8_t> filtered(stride * hdr.height);
+    if (!ZlibInflate(idat, idatSize, filtered.data(), filtered.size())) {
+        return false;
+    }
+
+    const std::vector<uint8_t> zeroRow(rowBytes, 0);
+    const bool direct = hdr.colorType == kRgba && hdr.bitDepth == 8;
+    const uint8_t* prev = zeroRow.data();
+    for (uint32_t y = 0; y < hdr.height; ++y) {
+        uint8_t* line = filtered.data() + y * stride;
+        const uint8_t filter = line[0];
+        if (filter > kFilterPaeth) {
+            return false;
+        }
+        // Rows are reconstructed in place and only then copied out, so dst
+        // is never read back: it may be write-combined upload memory.
+        UnfilterRow(filter, line + 1, line + 1, prev, rowBytes, bpp, simd);
+        uint8_t* dstRow = dst + y * dstPitch;
+        if (direct) {
+            std::memcpy(dstRow, line + 1, rowBytes);
+        } else {
+            ExpandRow(hdr, line + 1, dstRow, palette, key);
+        }
+        prev = line + 1;
+    }
+    return true;
+}
@@ -0,0 +1,7 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+bool PngReadInfo(const uint8_t* data, size_t size, int& width, int& height);
+// simd = false forces the scalar unfilter routines, for comparison.
+bool PngDecode(const uint8_t* data, size_t size, uint8_t* dst, size_t dstPitch, bool simd = true);
@@ -0,0 +1,95 @@
+#include "QoiDecoder.h"
+
+#include <cstring>
+
+// https://qoiformat.org/qoi-specification.pdf
+
+namespace {
+
+constexpr size_t kHeaderBytes = 14;
+constexpr size_t kPaddingBytes = 8;
+
+constexpr uint8_t kOpIndex = 0x00;
+constexpr uint8_t kOpDiff = 0x40;
+constexpr uint8_t kOpLuma = 0x80;
+constexpr uint8_t kOpRgb = 0xFE;
+constexpr uint8_t kOpRgba = 0xFF;
+constexpr uint8_t kMask2 = 0xC0;
+
+uint32_t ReadBE32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+} // namespace
+
+bool QoiReadInfo(const uint8_t* data, size_t size, int& width, int& height) {
+    if (size < kHeaderBytes + kPaddingBytes || std::memcmp(data, "qoif", 4) != 0) {
+        return false;
+    }
+    const uint32_t w = ReadBE32(data + 4);
+    const uint32_t h = ReadBE32(data + 8);
+    const uint8_t channels = data[12];
+    if (channels < 3 || channels > 4 || w == 0 || h == 0 || w > 0x7FFFFFFF || h > 0x7FFFFFFF) {
+        return false;
+    }
+    width = static_cast<int>(w);
+    height = static_cast<int>(h);
+    return true;
+}
+
+bool QoiDecode(const uint8_t* data, size_t size, uint8_t* dst, size_t dstPitch) {
+    int width = 0;
+    int height = 0;
+    if (!QoiReadInfo(data, size, width, height)) {
+        return false;
+    }
+
+    uint8_t index[64][4] = {};
+    uint8_t px[4] = {0, 0, 0, 255};
+    const uint8_t* p = data + kHeaderBytes;
+    const uint8_t* end = data + size - kPaddingBytes;
+    int run = 0;
+
+    for (int y = 0; y < height; ++y) {
+        uint8_t* row = dst + static_cast<size_t>(y) * dstPitch;
+        for (int x = 0; x < width; ++x) {
+            if (run > 0) {
+                --run;
+            } else if (p < end) {
+                const uint8_t b1 = *p++;
+                if (b1 == kOpRgb) {
+                    if (end - p < 3) return false;
+                    px[0] = p[0];
+                    px[1] = p[1];
+                    px[2] = p[2];
+                    p += 3;
+                } else if (b1 == kOpRgba) {
+                    if (end - p < 4) return false;
+                    std::memcpy(px, p, 4);
+                    p += 4;
+                } else if ((b1 & kMask2) == kOpIndex) {
+                    std::memcpy(px, index[b1], 4);
+                } else if ((b1 & kMask2) == kOpDiff) {
+                    px[0] = static_cast<uint8_t>(px[0] + ((b1 >> 4) & 3) - 2);
+                    px[1] = static_cast<uint8_t>(px[1] + ((b1 >> 2) & 3) - 2);
+                    px[2] = static_cast<uint8_t>(px[2] + (b1 & 3) - 2);
+                } else if ((b1 & kMask2) == kOpLuma) {
+                    if (end - p < 1) return false;
+                    const uint8_t b2 = *p++;
+                    const int vg = (b1 & 0x3F) - 32;
+                    px[0] = static_cast<uint8_t>(px[0] + vg - 8 + ((b2 >> 4) & 0x0F));
+                    px[1] = static_cast<uint8_t>(px[1] + vg);
+                    px[2] = static_cast<uint8_t>(px[2] + vg - 8 + (b2 & 0x0F));
+                } else { // QOI_OP_RUN
+                    run = b1 & 0x3F;
+                }
+                const int h = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) & 63;
+                std::memcpy(index[h], px, 4);
+            } else {
+                return false; // truncated stream
+            }
+            std::memcpy(row + x * 4, px, 4);
+        }
+    }
+    return true;
+}
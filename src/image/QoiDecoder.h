@@ -0,0 +1,6 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+bool QoiReadInfo(const uint8_t* data, size_t size, int& width, int& height);
+bool QoiDecode(const uint8_t* data, size_t size, uint8_t* dst, size_t dstPitch);
@@ -0,0 +1,93 @@
+#include "LoopbackTransport.h"
+
+#include <cstring>
+
+LoopbackNetwork::LoopbackNetwork(const LoopbackConfig& cfg)
+    : cfg_(cfg), rng_(cfg.seed ? cfg.seed : 1) {}
+
+LoopbackNetwork::~LoopbackNetwork() = default;
+
+std::unique_ptr<LoopbackTransport> LoopbackNetwork::CreateEndpoint() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const PeerId id = nextId_++;
+    inboxes_[id];
+    return std::unique_ptr<LoopbackTransport>(new LoopbackTransport(this, id));
+}
+
+uint64_t LoopbackNetwork::PacketsSent() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return packetsSent_;
+}
+
+uint64_t LoopbackNetwork::PacketsDropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return packetsDropped_;
+}
+
+uint64_t LoopbackNetwork::BytesSent() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytesSent_;
+}
+
+bool LoopbackNetwork::ShouldDrop() {
+    if (cfg_.dropRate <= 0.0f) {
+        return false;
+    }
+    // xorshift32, deterministic for a given seed
+    rng_ ^= rng_ << 13;
+    rng_ ^= rng_ >> 17;
+    rng_ ^= rng_ << 5;
+    return static_cast<float>(rng_ & 0xFFFFFF) / 16777216.0f < cfg_.dropRate;
+}
+
+bool LoopbackNetwork::Deliver(PeerId from, PeerId to, const void* data, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = inboxes_.find(to);
+    if (it == inboxes_.end()) {
+        return false;
+    }
+    ++packetsSent_;
+    bytesSent_ += size;
+    if (ShouldDrop()) {
+        ++packetsDropped_;
+        return true;
+    }
+    NetPacket packet;
+    packet.from = from;
+    packet.data.resize(size);
+    if (size > 0) {
+        std::memcpy(packet.data.data(), data, size);
+    }
+    it->second.packets.push_back(std::move(packet));
+    return true;
+}
+
+bool LoopbackNetwork::Pop(PeerId self, NetPacket& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = inboxes_.find(self);
+    if (it == inboxes_.end() || it->second.packets.empty()) {
+        return false;
+    }
+    out = std::move(it->second.packets.front());
+    it->second.packets.pop_front();
+    return true;
+}
+
+void LoopbackNetwork::Remove(PeerId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    inboxes_.erase(id);
+}
+
+LoopbackTransport::~LoopbackTransport() {
+    if (net_) {
+        net_->Remove(id_);
+    }
+}
+
+bool LoopbackTransport::Send(PeerId to, const void* data, size_t size) {
+    return net_->Deliver(id_, to, data, size);
+}
+
+bool LoopbackTransport::Receive(NetPacket& out) {
+    return net_->Pop(id_, out);
+}
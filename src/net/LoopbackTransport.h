@@ -0,0 +1,66 @@
+#pragma once
+#include "NetTransport.h"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+struct LoopbackConfig {
+    float dropRate = 0.0f; // 0..1, fraction of packets silently lost
+    uint32_t seed = 1;
+};
+
+class LoopbackTransport;
+
+// In-process network hub. Every endpoint gets its own inbox, so a server and
+// hundreds of simulated clients can run inside one process.
+class LoopbackNetwork {
+public:
+    explicit LoopbackNetwork(const LoopbackConfig& cfg = LoopbackConfig());
+    ~LoopbackNetwork();
+
+    std::unique_ptr<LoopbackTransport> CreateEndpoint();
+
+    uint64_t PacketsSent() const;
+    uint64_t PacketsDropped() const;
+    uint64_t BytesSent() const;
+
+private:
+    friend class LoopbackTransport;
+
+    struct Inbox {
+        std::deque<NetPacket> packets;
+    };
+
+    bool Deliver(PeerId from, PeerId to, const void* data, size_t size);
+    bool Pop(PeerId self, NetPacket& out);
+    void Remove(PeerId id);
+    bool ShouldDrop();
+
+    LoopbackConfig cfg_;
+    mutable std::mutex mutex_;
+    std::unordered_map<PeerId, Inbox> inboxes_;
+    PeerId nextId_ = 1;
+    uint32_t rng_ = 1;
+    uint64_t packetsSent_ = 0;
+    uint64_t packetsDropped_ = 0;
+    uint64_t bytesSent_ = 0;
+};
+
+class LoopbackTransport : public INetTransport {
+public:
+    ~LoopbackTransport();
+
+    // INetTransport
+    PeerId LocalId() const override { return id_; }
+    bool Send(PeerId to, const void* data, size_t size) override;
+    bool Receive(NetPacket& out) override;
+
+private:
+    friend class LoopbackNetwork;
+    LoopbackTransport(LoopbackNetwork* net, PeerId id) : net_(net), id_(id) {}
+
+    LoopbackNetwork* net_ = nullptr;
+    PeerId id_ = 0;
+};
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using PeerId = uint32_t;
+
+struct NetPacket {
+    PeerId from = 0;
+    std::vector<uint8_t> data;
+};
+
+// Unreliable, unordered datagram transport. Replication only relies on
+// these guarantees, so sockets or the in-process loopback can back it.
+class INetTransport {
+public:
+    virtual ~INetTransport() = default;
+    virtual PeerId LocalId() const = 0;
+    virtual bool Send(PeerId to, const void* data, size_t size) = 0;
+    virtual bool Receive(NetPacket& out) = 0; // false when the queue is empty
+};
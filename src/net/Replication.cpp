@@ -0,0 +1,548 @@
+#include "Replication.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+enum MessageType : uint8_t {
+    kMsgHello = 1,
+    kMsgWelcome = 2,
+    kMsgInput = 3,
+    kMsgSnapshot = 4,
+    kMsgBye = 5,
+};
+
+enum EntryFlags : uint8_t {
+    kEntryRemoved = 1 << 0,
+};
+
+// type, seq, server time, entry count
+constexpr size_t kSnapshotHeaderBytes = 1 + 4 + 4 + 2;
+constexpr size_t kUpdateEntryBytes = 4 + 1 + 4 + 4;
+constexpr size_t kRemoveEntryBytes = 4 + 1;
+constexpr float kMoveEpsilon = 0.01f;
+constexpr float kOwnEntityPriority = 1000.0f;
+constexpr float kPlayerSize = 64.0f;
+
+class ByteWriter {
+public:
+    explicit ByteWriter(std::vector<uint8_t>& buf) : buf_(buf) { buf_.clear(); }
+
+    template <typename T>
+    void Put(T value) {
+        const size_t at = buf_.size();
+        buf_.resize(at + sizeof(T));
+        std::memcpy(buf_.data() + at, &value, sizeof(T));
+    }
+
+    template <typename T>
+    void PutAt(size_t at, T value) { std::memcpy(buf_.data() + at, &value, sizeof(T)); }
+
+    size_t Size() const { return buf_.size(); }
+
+private:
+    std::vector<uint8_t>& buf_;
+};
+
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    bool Get(T& value) {
+        if (pos_ + sizeof(T) > size_) {
+            return false;
+        }
+        std::memcpy(&value, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t pos_ = 0;
+};
+
+// Mirrors App::OnKey/App::Update, but with the tick dt instead of 1/60.
+void StepPlayer(GameState& s, uint8_t buttons, float dt, float maxX, float maxY) {
+    const float step = s.speed * dt;
+    if (buttons & kInputUp) s.playerY -= step;
+    if (buttons & kInputDown) s.playerY += step;
+    if (buttons & kInputLeft) s.playerX -= step;
+    if (buttons & kInputRight) s.playerX += step;
+    s.playerX = std::clamp(s.playerX, 0.0f, maxX);
+    s.playerY = std::clamp(s.playerY, 0.0f, maxY);
+}
+
+// Sequence numbers wrap; compare on the signed distance.
+bool SeqNewer(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b) > 0;
+}
+
+} // namespace
+
+ReplicationServer::ReplicationServer(INetTransport& transport, const ReplicationConfig& cfg)
+    : transport_(transport),
+      cfg_(cfg),
+      grid_(cfg.worldWidth, cfg.worldHeight, cfg.cellSize) {}
+
+uint32_t ReplicationServer::SpawnEntity(float x, float y) {
+    Entity e;
+    e.id = nextEntityId_++;
+    e.state.playerX = x;
+    e.state.playerY = y;
+    entityIndex_[e.id] = entities_.size();
+    entities_.push_back(e);
+    return e.id;
+}
+
+void ReplicationServer::DespawnEntity(uint32_t id) {
+    RemoveEntity(id);
+}
+
+void ReplicationServer::SetEntityPosition(uint32_t id, float x, float y) {
+    if (Entity* e = FindEntity(id)) {
+        e->state.playerX = x;
+        e->state.playerY = y;
+    }
+}
+
+ReplicationServer::Entity* ReplicationServer::FindEntity(uint32_t id) {
+    auto it = entityIndex_.find(id);
+    return it == entityIndex_.end() ? nullptr : &entities_[it->second];
+}
+
+void ReplicationServer::RemoveEntity(uint32_t id) {
+    auto it = entityIndex_.find(id);
+    if (it == entityIndex_.end()) {
+        return;
+    }
+    const size_t index = it->second;
+    entityIndex_.erase(it);
+    if (index + 1 != entities_.size()) {
+        entities_[index] = entities_.back();
+        entityIndex_[entities_[index].id] = index;
+    }
+    entities_.pop_back();
+}
+
+void ReplicationServer::Tick(float dt) {
+    using Clock = std::chrono::steady_clock;
+    const auto tickStart = Clock::now();
+
+    time_ += dt;
+    ++stats_.tick;
+    stats_.bytesSent = 0;
+    stats_.entriesSent = 0;
+    stats_.entriesDeferred = 0;
+    stats_.clientUsMax = 0.0;
+
+    ReceivePackets();
+
+    timedOut_.clear();
+    for (const auto& kv : clients_) {
+        if (time_ - kv.second.lastHeard > cfg_.clientTimeout) {
+            timedOut_.push_back(kv.first);
+        }
+    }
+    for (PeerId peer : timedOut_) {
+        DropClient(peer);
+    }
+
+    Simulate(dt);
+    RebuildGrid();
+
+    double clientUsTotal = 0.0;
+    for (auto& kv : clients_) {
+        const auto start = Clock::now();
+        Replicate(kv.second);
+        const double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        clientUsTotal += us;
+        stats_.clientUsMax = std::max(stats_.clientUsMax, us);
+    }
+
+    stats_.clients = clients_.size();
+    stats_.entities = entities_.size();
+    stats_.clientUsAvg = clients_.empty() ? 0.0 : clientUsTotal / clients_.size();
+    stats_.tickMs = std::chrono::duration<double, std::milli>(Clock::now() - tickStart).count();
+}
+
+void ReplicationServer::ReceivePackets() {
+    NetPacket packet;
+    while (transport_.Receive(packet)) {
+        if (packet.data.empty()) {
+            continue;
+        }
+        const uint8_t type = packet.data[0];
+        if (type == kMsgHello) {
+            OnHello(packet.from);
+            continue;
+        }
+        auto it = clients_.find(packet.from);
+        if (it == clients_.end()) {
+            continue;
+        }
+        it->second.lastHeard = time_;
+        if (type == kMsgInput) {
+            OnInput(it->second, packet.data.data() + 1, packet.data.size() - 1);
+        } else if (type == kMsgBye) {
+            DropClient(packet.from);
+        }
+    }
+}
+
+void ReplicationServer::OnHello(PeerId peer) {
+    auto it = clients_.find(peer);
+    if (it == clients_.end()) {
+        Client client;
+        client.peer = peer;
+        client.entityId = SpawnEntity(cfg_.worldWidth * 0.5f, cfg_.worldHeight * 0.5f);
+        FindEntity(client.entityId)->owner = peer;
+        it = clients_.emplace(peer, std::move(client)).first;
+    }
+    it->second.lastHeard = time_;
+
+    // Welcome is resent for every Hello, since either side of the handshake can be lost.
+    std::vector<uint8_t> msg;
+    ByteWriter w(msg);
+    w.Put<uint8_t>(kMsgWelcome);
+    w.Put<uint32_t>(it->second.entityId);
+    transport_.Send(peer, msg.data(), msg.size());
+}
+
+void ReplicationServer::OnInput(Client& client, const uint8_t* data, size_t size) {
+    ByteReader r(data, size);
+    uint32_t ackSeq = 0;
+    uint32_t inputSeq = 0;
+    uint8_t buttons = 0;
+    if (!r.Get(ackSeq) || !r.Get(inputSeq) || !r.Get(buttons)) {
+        return;
+    }
+    if (ackSeq != 0) {
+        OnAck(client, ackSeq);
+    }
+    if (SeqNewer(inputSeq, client.lastInputSeq)) {
+        client.lastInputSeq = inputSeq;
+        if (Entity* e = FindEntity(client.entityId)) {
+            e->buttons = buttons;
+        }
+    }
+}
+
+void ReplicationServer::OnAck(Client& client, uint32_t seq) {
+    // Only the acked snapshot itself is known to have arrived. Older ones in
+    // flight may or may not have been applied too (the client applies every
+    // snapshot newer than its last), so they are discarded and what they
+    // carried is resent.
+    while (!client.inFlight.empty() && SeqNewer(seq, client.inFlight.front().seq)) {
+        DiscardSnapshot(client, client.inFlight.front());
+        client.inFlight.pop_front();
+    }
+    if (client.inFlight.empty() || client.inFlight.front().seq != seq) {
+        return;
+    }
+    for (const SentEntry& entry : client.inFlight.front().entries) {
+        if (entry.removed) {
+            client.views.erase(entry.id);
+            continue;
+        }
+        EntityView& view = client.views[entry.id];
+        view.x = entry.x;
+        view.y = entry.y;
+        view.known = true;
+        view.stale = false; // newer than anything discarded
+    }
+    client.inFlight.pop_front();
+}
+
+void ReplicationServer::DiscardSnapshot(Client& client, const SentSnapshot& snapshot) {
+    // The view is recreated if it was dropped meanwhile: the client may be
+    // showing an entity the server no longer tracks for it.
+    for (const SentEntry& entry : snapshot.entries) {
+        client.views[entry.id].stale = true;
+    }
+}
+
+void ReplicationServer::DropClient(PeerId peer) {
+    auto it = clients_.find(peer);
+    if (it == clients_.end()) {
+        return;
+    }
+    RemoveEntity(it->second.entityId);
+    clients_.erase(it);
+}
+
+void ReplicationServer::Simulate(float dt) {
+    const float maxX = cfg_.worldWidth - kPlayerSize;
+    const float maxY = cfg_.worldHeight - kPlayerSize;
+    for (Entity& e : entities_) {
+        if (e.owner != 0) {
+            StepPlayer(e.state, e.buttons, dt, maxX, maxY);
+        }
+    }
+}
+
+void ReplicationServer::RebuildGrid() {
+    const size_t n = entities_.size();
+    gridIds_.resize(n);
+    gridXs_.resize(n);
+    gridYs_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        gridIds_[i] = entities_[i].id;
+        gridXs_[i] = entities_[i].state.playerX;
+        gridYs_[i] = entities_[i].state.playerY;
+    }
+    grid_.Build(gridIds_.data(), gridXs_.data(), gridYs_.data(), n);
+}
+
+void ReplicationServer::Replicate(Client& client) {
+    const Entity* self = FindEntity(client.entityId);
+    if (!self) {
+        return;
+    }
+    const float cx = self->state.playerX;
+    const float cy = self->state.playerY;
+    const float radius = cfg_.interestRadius;
+    const uint64_t tick = stats_.tick;
+
+    queryIds_.clear();
+    candidates_.clear();
+    grid_.Query(cx, cy, radius, queryIds_);
+
+    for (uint32_t id : queryIds_) {
+        const Entity& e = entities_[entityIndex_[id]];
+        const float dx = e.state.playerX - cx;
+        const float dy = e.state.playerY - cy;
+        const float distSq = dx * dx + dy * dy;
+        if (distSq > radius * radius) {
+            continue;
+        }
+        EntityView& view = client.views[id];
+        view.seenTick = tick;
+        if (view.known && !view.stale &&
+            std::fabs(view.x - e.state.playerX) < kMoveEpsilon &&
+            std::fabs(view.y - e.state.playerY) < kMoveEpsilon) {
+            continue;
+        }
+        // Near entities gain priority faster; whatever misses the budget keeps
+        // accumulating, so distant updates are delayed but never starved.
+        view.priority += (id == client.entityId)
+                             ? kOwnEntityPriority
+                             : 1.0f + radius / (std::sqrt(distSq) + cfg_.cellSize);
+        candidates_.push_back({id, view.priority, false});
+    }
+
+    for (auto it = client.views.begin(); it != client.views.end();) {
+        EntityView& view = it->second;
+        if (view.seenTick == tick) {
+            ++it;
+            continue;
+        }
+        if (!view.known && !view.stale) {
+            // Never acked and now out of interest. An update still in flight
+            // brings the view back when it is acked or discarded.
+            it = client.views.erase(it);
+            continue;
+        }
+        view.priority += 1.0f;
+        candidates_.push_back({it->first, view.priority, true});
+        ++it;
+    }
+
+    // Only the entries that can fit need ordering: at most as many as there
+    // are removals (the smallest entry) in the budget.
+    const size_t budget = static_cast<size_t>(std::max(cfg_.snapshotBudgetBytes, 0));
+    const size_t fit = budget > kSnapshotHeaderBytes ? (budget - kSnapshotHeaderBytes) / kRemoveEntryBytes : 0;
+    const size_t sorted = std::min({candidates_.size(), fit, size_t{0xFFFF}});
+    std::partial_sort(candidates_.begin(), candidates_.begin() + sorted, candidates_.end(),
+                      [](const Candidate& a, const Candidate& b) { return a.priority > b.priority; });
+
+    SentSnapshot sent;
+    sent.seq = client.nextSeq++;
+    ByteWriter w(packet_);
+    w.Put<uint8_t>(kMsgSnapshot);
+    w.Put<uint32_t>(sent.seq);
+    w.Put<float>(time_);
+    w.Put<uint16_t>(0);
+
+    size_t written = 0;
+    for (const Candidate& c : candidates_) {
+        const size_t entryBytes = c.removed ? kRemoveEntryBytes : kUpdateEntryBytes;
+        if (w.Size() + entryBytes > budget || written == 0xFFFF) {
+            stats_.entriesDeferred += candidates_.size() - written;
+            break;
+        }
+        SentEntry entry;
+        entry.id = c.id;
+        entry.removed = c.removed;
+        w.Put<uint32_t>(c.id);
+        w.Put<uint8_t>(c.removed ? kEntryRemoved : 0);
+        if (!c.removed) {
+            const Entity& e = entities_[entityIndex_[c.id]];
+            entry.x = e.state.playerX;
+            entry.y = e.state.playerY;
+            w.Put<float>(entry.x);
+            w.Put<float>(entry.y);
+        }
+        client.views[c.id].priority = 0.0f;
+        sent.entries.push_back(entry);
+        ++written;
+    }
+    w.PutAt<uint16_t>(kSnapshotHeaderBytes - 2, static_cast<uint16_t>(written));
+
+    transport_.Send(client.peer, packet_.data(), packet_.size());
+    stats_.bytesSent += packet_.size();
+    stats_.entriesSent += written;
+
+    client.inFlight.push_back(std::move(sent));
+    // Acks more than a second late are not worth tracking.
+    while (client.inFlight.size() > 64) {
+        DiscardSnapshot(client, client.inFlight.front());
+        client.inFlight.pop_front();
+    }
+}
+
+ReplicationClient::ReplicationClient(INetTransport& transport, PeerId server, float interpDelay)
+    : transport_(transport), server_(server), interpDelay_(interpDelay) {}
+
+ReplicationClient::~ReplicationClient() {
+    const uint8_t bye = kMsgBye;
+    transport_.Send(server_, &bye, 1);
+}
+
+void ReplicationClient::Update(float dt) {
+    ReceivePackets();
+
+    if (!Connected()) {
+        const uint8_t hello = kMsgHello;
+        transport_.Send(server_, &hello, 1);
+        return;
+    }
+
+    SendInput();
+
+    if (timeSynced_) {
+        renderTime_ += dt;
+        const float target = latestServerTime_ - interpDelay_;
+        const float error = target - renderTime_;
+        // Snap on large drift (first sync, stalls), otherwise ease toward the
+        // target so the render clock never jumps backwards visibly.
+        if (std::fabs(error) > 0.25f) {
+            renderTime_ = target;
+        } else {
+            renderTime_ += error * 0.1f;
+        }
+    }
+    Interpolate();
+}
+
+void ReplicationClient::ReceivePackets() {
+    NetPacket packet;
+    while (transport_.Receive(packet)) {
+        if (packet.from != server_ || packet.data.empty()) {
+            continue;
+        }
+        const uint8_t type = packet.data[0];
+        if (type == kMsgWelcome) {
+            ByteReader r(packet.data.data() + 1, packet.data.size() - 1);
+            uint32_t entityId = 0;
+            if (r.Get(entityId)) {
+                localEntity_ = entityId;
+            }
+        } else if (type == kMsgSnapshot) {
+            OnSnapshot(packet.data.data() + 1, packet.data.size() - 1);
+        }
+    }
+}
+
+void ReplicationClient::OnSnapshot(const uint8_t* data, size_t size) {
+    ByteReader r(data, size);
+    uint32_t seq = 0;
+    float serverTime = 0.0f;
+    uint16_t count = 0;
+    if (!r.Get(seq) || !r.Get(serverTime) || !r.Get(count)) {
+        return;
+    }
+    if (lastSnapshotSeq_ != 0 && !SeqNewer(seq, lastSnapshotSeq_)) {
+        return; // stale or duplicate
+    }
+    lastSnapshotSeq_ = seq;
+    latestServerTime_ = serverTime;
+    if (!timeSynced_) {
+        renderTime_ = serverTime - interpDelay_;
+        timeSynced_ = true;
+    }
+    ++snapshotsReceived_;
+
+    for (uint16_t i = 0; i < count; ++i) {
+        uint32_t id = 0;
+        uint8_t flags = 0;
+        if (!r.Get(id) || !r.Get(flags)) {
+            return;
+        }
+        if (flags & kEntryRemoved) {
+            tracks_.erase(id);
+            continue;
+        }
+        Sample s;
+        s.time = serverTime;
+        if (!r.Get(s.x) || !r.Get(s.y)) {
+            return;
+        }
+        Track& track = tracks_[id];
+        if (track.count == kSamples) {
+            std::memmove(&track.samples[0], &track.samples[1], sizeof(Sample) * (kSamples - 1));
+            --track.count;
+        }
+        track.samples[track.count++] = s;
+    }
+}
+
+void ReplicationClient::SendInput() {
+    ByteWriter w(packet_);
+    w.Put<uint8_t>(kMsgInput);
+    w.Put<uint32_t>(lastSnapshotSeq_); // doubles as the ack
+    w.Put<uint32_t>(++inputSeq_);
+    w.Put<uint8_t>(buttons_);
+    transport_.Send(server_, packet_.data(), packet_.size());
+}
+
+void ReplicationClient::Interpolate() {
+    interpolated_.clear();
+    interpolated_.reserve(tracks_.size());
+    for (const auto& kv : tracks_) {
+        const Track& track = kv.second;
+        if (track.count == 0) {
+            continue;
+        }
+        RemoteEntity out;
+        out.id = kv.first;
+        const Sample& last = track.samples[track.count - 1];
+        out.x = last.x;
+        out.y = last.y;
+        // The local entity is shown at the newest state; remote ones are
+        // blended between the two samples around the render time, and held
+        // at the newest one when updates run dry (no extrapolation).
+        if (kv.first != localEntity_ && renderTime_ < last.time) {
+            const Sample& first = track.samples[0];
+            out.x = first.x;
+            out.y = first.y;
+            for (int i = 1; i < track.count; ++i) {
+                const Sample& a = track.samples[i - 1];
+                const Sample& b = track.samples[i];
+                if (renderTime_ >= a.time && renderTime_ <= b.time) {
+                    const float span = b.time - a.time;
+                    const float t = span > 0.0f ? (renderTime_ - a.time) / span : 1.0f;
+                    out.x = a.x + (b.x - a.x) * t;
+                    out.y = a.y + (b.y - a.y) * t;
+                    break;
+                }
+            }
+        }
+        interpolated_.push_back(out);
+    }
+}
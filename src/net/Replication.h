@@ -0,0 +1,194 @@
+#pragma once
+#include "NetTransport.h"
+#include "SpatialGrid.h"
+#include "../core/App.h"
+
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+enum InputButtons : uint8_t {
+    kInputUp = 1 << 0,
+    kInputDown = 1 << 1,
+    kInputLeft = 1 << 2,
+    kInputRight = 1 << 3,
+};
+
+struct ReplicationConfig {
+    float worldWidth = 4096.0f;
+    float worldHeight = 4096.0f;
+    float cellSize = 256.0f;
+    float interestRadius = 800.0f;
+    int snapshotBudgetBytes = 1200; // per client per tick, roughly one MTU
+    float clientTimeout = 5.0f;     // seconds without packets before a client is dropped
+};
+
+struct ServerStats {
+    uint64_t tick = 0;
+    size_t clients = 0;
+    size_t entities = 0;
+    double tickMs = 0.0;          // last tick, wall time
+    double clientUsAvg = 0.0;     // last tick, replication cost per client
+    double clientUsMax = 0.0;
+    uint64_t bytesSent = 0;       // last tick, all clients
+    size_t entriesSent = 0;
+    size_t entriesDeferred = 0;   // over budget, carried to the next tick
+};
+
+// Authoritative simulation. Each connected peer owns one player entity driven
+// by its input; every tick each client receives a delta snapshot against the
+// last state it acknowledged, limited to its area of interest and packed by
+// accumulated priority until the byte budget is spent.
+class ReplicationServer {
+public:
+    ReplicationServer(INetTransport& transport, const ReplicationConfig& cfg = ReplicationConfig());
+
+    uint32_t SpawnEntity(float x, float y); // server-owned, not tied to a peer
+    void DespawnEntity(uint32_t id);
+    void SetEntityPosition(uint32_t id, float x, float y);
+
+    void Tick(float dt);
+
+    const ServerStats& Stats() const { return stats_; }
+    size_t ClientCount() const { return clients_.size(); }
+
+private:
+    struct Entity {
+        uint32_t id = 0;
+        PeerId owner = 0;
+        GameState state;
+        uint8_t buttons = 0;
+    };
+
+    // What one client has acknowledged about one entity.
+    struct EntityView {
+        float x = 0.0f;
+        float y = 0.0f;
+        float priority = 0.0f;
+        uint64_t seenTick = 0;
+        bool known = false;
+        // Carried by a snapshot whose ack never came. The client may or may
+        // not have applied it, so x/y/known cannot be trusted until an acked
+        // snapshot carries the entity again.
+        bool stale = false;
+    };
+
+    struct SentEntry {
+        uint32_t id = 0;
+        float x = 0.0f;
+        float y = 0.0f;
+        bool removed = false;
+    };
+
+    struct SentSnapshot {
+        uint32_t seq = 0;
+        std::vector<SentEntry> entries;
+    };
+
+    struct Client {
+        PeerId peer = 0;
+        uint32_t entityId = 0;
+        uint32_t nextSeq = 1;
+        uint32_t lastInputSeq = 0;
+        float lastHeard = 0.0f;
+        std::unordered_map<uint32_t, EntityView> views;
+        std::deque<SentSnapshot> inFlight;
+    };
+
+    struct Candidate {
+        uint32_t id;
+        float priority;
+        bool removed;
+    };
+
+    void ReceivePackets();
+    void OnHello(PeerId peer);
+    void OnInput(Client& client, const uint8_t* data, size_t size);
+    void OnAck(Client& client, uint32_t seq);
+    void DiscardSnapshot(Client& client, const SentSnapshot& snapshot);
+    void DropClient(PeerId peer);
+    void Simulate(float dt);
+    void RebuildGrid();
+    void Replicate(Client& client);
+
+    Entity* FindEntity(uint32_t id);
+    void RemoveEntity(uint32_t id);
+
+    INetTransport& transport_;
+    ReplicationConfig cfg_;
+    SpatialGrid grid_;
+    ServerStats stats_;
+    float time_ = 0.0f;
+    uint32_t nextEntityId_ = 1;
+
+    std::vector<Entity> entities_;
+    std::unordered_map<uint32_t, size_t> entityIndex_;
+    std::unordered_map<PeerId, Client> clients_;
+
+    // Per-tick scratch, reused to keep Tick allocation-free in steady state.
+    std::vector<uint32_t> gridIds_;
+    std::vector<float> gridXs_;
+    std::vector<float> gridYs_;
+    std::vector<uint32_t> queryIds_;
+    std::vector<Candidate> candidates_;
+    std::vector<PeerId> timedOut_;
+    std::vector<uint8_t> packet_;
+};
+
+struct RemoteEntity {
+    uint32_t id = 0;
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+// Client side: sends input and acks, and renders remote entities
+// interpDelay seconds behind the newest snapshot so motion stays smooth
+// between (possibly budget-deferred) updates.
+class ReplicationClient {
+public:
+    ReplicationClient(INetTransport& transport, PeerId server, float interpDelay = 0.1f);
+    ~ReplicationClient();
+
+    void SetInput(uint8_t buttons) { buttons_ = buttons; }
+    void Update(float dt);
+
+    bool Connected() const { return localEntity_ != 0; }
+    uint32_t LocalEntity() const { return localEntity_; }
+    const std::vector<RemoteEntity>& Entities() const { return interpolated_; }
+    uint64_t SnapshotsReceived() const { return snapshotsReceived_; }
+
+private:
+    static constexpr int kSamples = 4;
+
+    struct Sample {
+        float time = 0.0f;
+        float x = 0.0f;
+        float y = 0.0f;
+    };
+
+    struct Track {
+        Sample samples[kSamples];
+        int count = 0;
+    };
+
+    void ReceivePackets();
+    void OnSnapshot(const uint8_t* data, size_t size);
+    void SendInput();
+    void Interpolate();
+
+    INetTransport& transport_;
+    PeerId server_ = 0;
+    float interpDelay_ = 0.1f;
+    uint8_t buttons_ = 0;
+    uint32_t localEntity_ = 0;
+    uint32_t inputSeq_ = 0;
+    uint32_t lastSnapshotSeq_ = 0;
+    float latestServerTime_ = 0.0f;
+    float renderTime_ = 0.0f;
+    bool timeSynced_ = false;
+    uint64_t snapshotsReceived_ = 0;
+
+    std::unordered_map<uint32_t, Track> tracks_;
+    std::vector<RemoteEntity> interpolated_;
+    std::vector<uint8_t> packet_;
+};
@@ -0,0 +1,50 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float worldWidth, float worldHeight, float cellSize)
+    : cellSize_(std::max(cellSize, 1.0f)) {
+    invCellSize_ = 1.0f / cellSize_;
+    cellsX_ = std::max(1, static_cast<int>(std::ceil(worldWidth * invCellSize_)));
+    cellsY_ = std::max(1, static_cast<int>(std::ceil(worldHeight * invCellSize_)));
+    cellStart_.assign(static_cast<size_t>(cellsX_) * cellsY_ + 1, 0);
+}
+
+int SpatialGrid::CellOf(float x, float y) const {
+    const int cx = std::clamp(static_cast<int>(x * invCellSize_), 0, cellsX_ - 1);
+    const int cy = std::clamp(static_cast<int>(y * invCellSize_), 0, cellsY_ - 1);
+    return cy * cellsX_ + cx;
+}
+
+void SpatialGrid::Build(const uint32_t* ids, const float* xs, const float* ys, size_t count) {
+    std::fill(cellStart_.begin(), cellStart_.end(), 0u);
+    scratchCells_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const int cell = CellOf(xs[i], ys[i]);
+        scratchCells_[i] = cell;
+        ++cellStart_[cell + 1];
+    }
+    for (size_t c = 1; c < cellStart_.size(); ++c) {
+        cellStart_[c] += cellStart_[c - 1];
+    }
+
+    items_.resize(count);
+    cursor_.assign(cellStart_.begin(), cellStart_.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        items_[cursor_[scratchCells_[i]]++] = ids[i];
+    }
+}
+
+void SpatialGrid::Query(float x, float y, float radius, std::vector<uint32_t>& out) const {
+    const int x0 = std::clamp(static_cast<int>((x - radius) * invCellSize_), 0, cellsX_ - 1);
+    const int x1 = std::clamp(static_cast<int>((x + radius) * invCellSize_), 0, cellsX_ - 1);
+    const int y0 = std::clamp(static_cast<int>((y - radius) * invCellSize_), 0, cellsY_ - 1);
+    const int y1 = std::clamp(static_cast<int>((y + radius) * invCellSize_), 0, cellsY_ - 1);
+    for (int cy = y0; cy <= y1; ++cy) {
+        // Cells in one row are adjacent in items_, so each row is one span.
+        const uint32_t begin = cellStart_[cy * cellsX_ + x0];
+        const uint32_t end = cellStart_[cy * cellsX_ + x1 + 1];
+        out.insert(out.end(), items_.begin() + begin, items_.begin() + end);
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Uniform grid over a bounded world, rebuilt in bulk every tick. Items are
+// bucketed with a counting sort, so a rebuild is O(items + cells) and each
+// cell is a contiguous run of ids.
+class SpatialGrid {
+public:
+    SpatialGrid(float worldWidth, float worldHeight, float cellSize);
+
+    void Build(const uint32_t* ids, const float* xs, const float* ys, size_t count);
+
+    // Appends every id whose cell overlaps the square around (x, y).
+    void Query(float x, float y, float radius, std::vector<uint32_t>& out) const;
+
+    int CellsX() const { return cellsX_; }
+    int CellsY() const { return cellsY_; }
+
+private:
+    int CellOf(float x, float y) const;
+
+    float cellSize_ = 1.0f;
+    float invCellSize_ = 1.0f;
+    int cellsX_ = 1;
+    int cellsY_ = 1;
+    std::vector<uint32_t> cellStart_; // cellsX_ * cellsY_ + 1 offsets into items_
+    std::vector<uint32_t> items_;
+    std::vector<int> scratchCells_;
+    std::vector<uint32_t> cursor_; // Build scratch: next free slot per cell
+};
@@ -6,14 +6,20 @@
 #include <dxgi.h>
 #include <combaseapi.h>
 
+#include <cstdio>
 #include <string>
 #include <stdexcept>
 
+#ifndef WM_DPICHANGED
+#define WM_DPICHANGED 0x02E0
+#endif
+
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "d3dcompiler.lib")
 
 #include "../../core/App.h"
+#include "../../core/FramePacer.h"
 #include "../../render/d3d11/D3D11Renderer.h"
 #include "../../ui/ImGuiLayer.h"
 #include "WinInput.h"
@@ -44,6 +50,17 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
                 g_App->OnKey(false, static_cast<int>(wParam));
             }
             return 0;
+        case WM_SIZE:
+        case WM_PAINT:
+        case WM_DISPLAYCHANGE:
+        case WM_DPICHANGED:
+            // The window contents no longer match the last presented frame,
+            // so the next one must be drawn even if the UI is unchanged.
+            // DefWindowProc still validates the paint region.
+            if (g_App) {
+                g_App->InvalidateFrame();
+            }
+            break;
         default:
             break;
     }
@@ -106,6 +123,7 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int) {
 
         ImGuiLayer imgui(hwnd, renderer.GetDevice(), renderer.GetDeviceContext());
         g_ImGui = &imgui;
+        app.SetOverlay(&imgui);
 
         void* tex = renderer.LoadTextureFromFile("assets/player.png");
         if (tex) {
@@ -115,10 +133,28 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int) {
         ShowWindow(hwnd, SW_SHOWDEFAULT);
         UpdateWindow(hwnd);
 
-        LARGE_INTEGER freq{};
-        LARGE_INTEGER prev{};
-        QueryPerformanceFrequency(&freq);
-        QueryPerformanceCounter(&prev);
+        SteadyFrameClock clock;
+        FramePacerConfig pacerCfg;
+        pacerCfg.targetHz = cfg.targetFps;
+        pacerCfg.lowLatency = cfg.lowLatency;
+        FramePacer pacer(clock, pacerCfg);
+        renderer.SetSyncInterval(cfg.vsync ? 1 : 0);
+        renderer.SetFramePacer(&pacer);
+
+        // HUD text goes through the glyph atlas when a font loads; ImGui is
+        // the fallback.
+        const bool nativeHud = app.Text().LoadFont(cfg.fontPath.c_str(), cfg.fontSize) ||
+                               app.Text().LoadFont("C:\\Windows\\Fonts\\consola.ttf", cfg.fontSize);
+
+        // Stats text is refreshed on an interval: a value that changes every
+        // frame would keep the UI fingerprint changing and defeat frame
+        // skipping. Lines are only re-formatted when their values change, so
+        // most frames reuse cached layouts.
+        constexpr int kHudLines = 4;
+        char hud[kHudLines][128] = {};
+        float statsTimer = 0.5f;
+        float shownX = -1.0f;
+        float shownY = -1.0f;
 
         MSG msg{};
         while (msg.message != WM_QUIT) {
@@ -128,11 +164,8 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int) {
                 continue;
             }
 
-            LARGE_INTEGER now{};
-            QueryPerformanceCounter(&now);
-            float dt = static_cast<float>(now.QuadPart - prev.QuadPart) /
-                       static_cast<float>(freq.QuadPart);
-            prev = now;
+            // Sleeps until the sampling point, so input below is as late as possible.
+            const float dt = pacer.BeginFrame();
 
             if (IsKeyDown('W')) app.OnKey(true, 'W');
             if (IsKeyDown('A')) app.OnKey(true, 'A');
@@ -141,10 +174,38 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int) {
 
             app.Update(dt);
 
+            statsTimer += dt;
+            if (statsTimer >= 0.5f) {
+                statsTimer = 0.0f;
+                const LatencyStats latency = pacer.Latency();
+                const FrameStats& frames = app.Stats();
+                std::snprintf(hud[0], sizeof(hud[0]), "FPS: %.1f", (dt > 0.0001f) ? (1.0f / dt) : 0.0f);
+                std::snprintf(hud[1], sizeof(hud[1]), "Input->Present: %.1f ms (p99 %.1f ms)",
+                              latency.avgMs, latency.p99Ms);
+                std::snprintf(hud[2], sizeof(hud[2]), "Frames: %llu drawn, %llu skipped",
+                              static_cast<unsigned long long>(frames.submitted),
+                              static_cast<unsigned long long>(frames.skipped));
+            }
+            if (app.State().playerX != shownX || app.State().playerY != shownY) {
+                shownX = app.State().playerX;
+                shownY = app.State().playerY;
+                std::snprintf(hud[3], sizeof(hud[3]), "Player: (%.1f, %.1f)", shownX, shownY);
+            }
+
+            if (nativeHud) {
+                float y = 8.0f;
+                for (const char* line : hud) {
+                    app.Text().Draw(8.0f, y, line);
+                    y += app.Text().LineHeight();
+                }
+            }
+
             imgui.Begin();
-            const float fps = (dt > 0.0001f) ? (1.0f / dt) : 0.0f;
-            imgui.Text("FPS: %.1f", fps);
-            imgui.Text("Player: (%.1f, %.1f)", app.State().playerX, app.State().playerY);
+            if (!nativeHud) {
+                for (const char* line : hud) {
+                    imgui.Text("%s", line);
+                }
+            }
             imgui.End();
 
             app.Render();
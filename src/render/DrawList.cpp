@@ -0,0 +1,175 @@
+#include "DrawList.h"
+#include "FrameHash.h"
+#include "../core/App.h"
+
+#include <algorithm>
+
+void DrawList::Reset() {
+    commands_.clear();
+    sprites_.clear();
+    fingerprint_ = kFrameHashSeed;
+}
+
+void DrawList::Push(Command& cmd) {
+    uint64_t h = HashValue(cmd.type, kFrameHashSeed);
+    switch (cmd.type) {
+        case CommandType::Clear:
+            h = HashBytes(cmd.color, sizeof(cmd.color), h);
+            break;
+        case CommandType::Overlay:
+            h = HashValue(cmd.overlay->Fingerprint(), h);
+            break;
+        case CommandType::Sprites:
+            h = HashBytes(sprites_.data() + cmd.firstSprite, cmd.spriteCount * sizeof(SpriteQuad), h);
+            h = HashValue(cmd.texture, h);
+            h = HashValue(cmd.version, h);
+            break;
+        default:
+            h = HashValue(cmd.x, h);
+            h = HashValue(cmd.y, h);
+            h = HashValue(cmd.w, h);
+            h = HashValue(cmd.h, h);
+            h = HashValue(cmd.texture, h);
+            break;
+    }
+    cmd.hash = h;
+    fingerprint_ = HashValue(h, fingerprint_);
+    commands_.push_back(cmd);
+}
+
+void DrawList::Clear(float r, float g, float b, float a) {
+    Command cmd;
+    cmd.type = CommandType::Clear;
+    cmd.color[0] = r;
+    cmd.color[1] = g;
+    cmd.color[2] = b;
+    cmd.color[3] = a;
+    Push(cmd);
+}
+
+void DrawList::Quad(float x, float y, float w, float h) {
+    Command cmd;
+    cmd.type = CommandType::Quad;
+    cmd.x = x;
+    cmd.y = y;
+    cmd.w = w;
+    cmd.h = h;
+    Push(cmd);
+}
+
+void DrawList::TexturedQuad(float x, float y, float w, float h, void* texture) {
+    Command cmd;
+    cmd.type = CommandType::TexturedQuad;
+    cmd.x = x;
+    cmd.y = y;
+    cmd.w = w;
+    cmd.h = h;
+    cmd.texture = texture;
+    Push(cmd);
+}
+
+void DrawList::Sprites(const SpriteQuad* quads, size_t count, void* texture, uint64_t textureVersion) {
+    if (count == 0) {
+        return;
+    }
+    Command cmd;
+    cmd.type = CommandType::Sprites;
+    cmd.texture = texture;
+    cmd.version = textureVersion;
+    cmd.firstSprite = static_cast<uint32_t>(sprites_.size());
+    cmd.spriteCount = static_cast<uint32_t>(count);
+    sprites_.insert(sprites_.end(), quads, quads + count);
+
+    float x0 = quads[0].x;
+    float y0 = quads[0].y;
+    float x1 = quads[0].x + quads[0].w;
+    float y1 = quads[0].y + quads[0].h;
+    for (size_t i = 1; i < count; ++i) {
+        x0 = std::min(x0, quads[i].x);
+        y0 = std::min(y0, quads[i].y);
+        x1 = std::max(x1, quads[i].x + quads[i].w);
+        y1 = std::max(y1, quads[i].y + quads[i].h);
+    }
+    cmd.x = x0;
+    cmd.y = y0;
+    cmd.w = x1 - x0;
+    cmd.h = y1 - y0;
+    Push(cmd);
+}
+
+void DrawList::Overlay(IFrameOverlay* overlay) {
+    if (!overlay) {
+        return;
+    }
+    Command cmd;
+    cmd.type = CommandType::Overlay;
+    cmd.overlay = overlay;
+    Push(cmd);
+}
+
+void DrawList::Damage(const DrawList& prev, float viewW, float viewH, std::vector<FrameRect>& out) const {
+    out.clear();
+    const FrameRect full{0.0f, 0.0f, viewW, viewH};
+
+    auto addBounds = [&](const Command& cmd) {
+        if (cmd.type == CommandType::Clear || cmd.type == CommandType::Overlay) {
+            return false; // no bounds known; caller falls back to full damage
+        }
+        FrameRect r;
+        r.x0 = std::max(cmd.x, 0.0f);
+        r.y0 = std::max(cmd.y, 0.0f);
+        r.x1 = std::min(cmd.x + cmd.w, viewW);
+        r.y1 = std::min(cmd.y + cmd.h, viewH);
+        if (r.x1 > r.x0 && r.y1 > r.y0) {
+            out.push_back(r);
+        }
+        return true;
+    };
+
+    const size_t count = std::max(commands_.size(), prev.commands_.size());
+    for (size_t i = 0; i < count; ++i) {
+        const Command* cur = i < commands_.size() ? &commands_[i] : nullptr;
+        const Command* old = i < prev.commands_.size() ? &prev.commands_[i] : nullptr;
+        if (cur && old && cur->hash == old->hash) {
+            continue;
+        }
+        if ((cur && !addBounds(*cur)) || (old && !addBounds(*old))) {
+            out.assign(1, full);
+            return;
+        }
+    }
+
+    if (out.size() > kMaxDamageRects) {
+        FrameRect u = out[0];
+        for (const FrameRect& r : out) {
+            u.x0 = std::min(u.x0, r.x0);
+            u.y0 = std::min(u.y0, r.y0);
+            u.x1 = std::max(u.x1, r.x1);
+            u.y1 = std::max(u.y1, r.y1);
+        }
+        out.assign(1, u);
+    }
+}
+
+void DrawList::Submit(IRenderer2D& renderer) const {
+    for (const Command& cmd : commands_) {
+        switch (cmd.type) {
+            case CommandType::Clear:
+                renderer.BeginFrame(cmd.color[0], cmd.color[1], cmd.color[2], cmd.color[3]);
+                break;
+            case CommandType::Quad:
+                renderer.DrawQuad(cmd.x, cmd.y, cmd.w, cmd.h);
+                break;
+            case CommandType::TexturedQuad:
+                renderer.DrawTexturedQuad(cmd.x, cmd.y, cmd.w, cmd.h, cmd.texture);
+                break;
+            case CommandType::Sprites:
+                renderer.DrawSprites(sprites_.data() + cmd.firstSprite, cmd.spriteCount, cmd.texture);
+                break;
+            case CommandType::Overlay:
+                cmd.overlay->Draw();
+                break;
+        }
+    }
+    renderer.EndFrame();
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class IRenderer2D;
+class IFrameOverlay;
+
+struct FrameRect {
+    float x0 = 0.0f;
+    float y0 = 0.0f;
+    float x1 = 0.0f;
+    float y1 = 0.0f;
+};
+
+// A screen-space quad with its own UV rect and tint. Colour is RGBA8 in
+// memory order (0xAABBGGRR as a little-endian integer).
+struct SpriteQuad {
+    float x = 0.0f;
+    float y = 0.0f;
+    float w = 0.0f;
+    float h = 0.0f;
+    float u0 = 0.0f;
+    float v0 = 0.0f;
+    float u1 = 1.0f;
+    float v1 = 1.0f;
+    uint32_t color = 0xFFFFFFFFu;
+};
+
+// One frame's submission stream, recorded before anything reaches the
+// renderer. Every command is hashed as it is recorded, so the frame has a
+// fingerprint to compare with the previous one and, when it differs, a
+// per-command diff to derive damage rectangles from.
+class DrawList {
+public:
+    static constexpr size_t kMaxDamageRects = 8;
+
+    void Reset();
+
+    void Clear(float r, float g, float b, float a);
+    void Quad(float x, float y, float w, float h);
+    void TexturedQuad(float x, float y, float w, float h, void* texture);
+    // Copies the quads into one batched command; texture may be null for
+    // untextured quads. When a texture's pixels can change under the same
+    // pointer (e.g. a glyph atlas being reset), pass its content version so
+    // the fingerprint sees the change.
+    void Sprites(const SpriteQuad* quads, size_t count, void* texture, uint64_t textureVersion = 0);
+    void Overlay(IFrameOverlay* overlay);
+
+    uint64_t Fingerprint() const { return fingerprint_; }
+    bool Empty() const { return commands_.empty(); }
+
+    // Regions covered by commands that differ from prev, clipped to the
+    // viewport. Falls back to one full-viewport rect when the clear colour or
+    // an overlay changed, or when the diff is too fragmented to be useful.
+    void Damage(const DrawList& prev, float viewW, float viewH, std::vector<FrameRect>& out) const;
+
+    void Submit(IRenderer2D& renderer) const;
+
+private:
+    enum class CommandType : uint8_t {
+        Clear,
+        Quad,
+        TexturedQuad,
+        Sprites,
+        Overlay,
+    };
+
+    struct Command {
+        CommandType type = CommandType::Clear;
+        float x = 0.0f;
+        float y = 0.0f;
+        float w = 0.0f;
+        float h = 0.0f;
+        float color[4] = {};
+        void* texture = nullptr;
+        IFrameOverlay* overlay = nullptr;
+        uint32_t firstSprite = 0; // Sprites: range in sprites_; x/y/w/h hold the bounds
+        uint32_t spriteCount = 0;
+        uint64_t version = 0;
+        uint64_t hash = 0;
+    };
+
+    void Push(Command& cmd);
+
+    std::vector<Command> commands_;
+    std::vector<SpriteQuad> sprites_;
+    uint64_t fingerprint_ = 0;
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// FNV-1a style mixing over 8-byte words (UI vertex buffers are hashed every
+// frame). Not cryptographic; it only has to tell consecutive frames apart.
+constexpr uint64_t kFrameHashSeed = 0xcbf29ce484222325ull;
+
+inline uint64_t HashBytes(const void* data, size_t size, uint64_t h = kFrameHashSeed) {
+    const uint64_t prime = 0x100000001b3ull;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, p + i, 8);
+        h = (h ^ word) * prime;
+        h ^= h >> 29;
+    }
+    for (; i < size; ++i) {
+        h = (h ^ p[i]) * prime;
+    }
+    return h;
+}
+
+template <typename T>
+inline uint64_t HashValue(const T& value, uint64_t h) {
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    return HashBytes(bytes, sizeof(T), h);
+}
@@ -2,6 +2,7 @@
 #include "TextureLoader.h"
 
 #include <d3dcompiler.h>
+#include <algorithm>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -48,21 +49,28 @@ Microsoft::WRL::ComPtr<ID3DBlob> CompileShader(const char* src,
     return blob;
 }
 
+// Quads per vertex buffer fill. The index buffer holds this many quads'
+// worth of indices, all relative to a base vertex.
+constexpr UINT kMaxBatchQuads = 4096;
+
+constexpr uint32_t kQuadColor = 0xFFE6B333u; // (0.2, 0.7, 0.9, 1)
+constexpr uint32_t kWhite = 0xFFFFFFFFu;
+
 const char* g_ShaderSrc = R"HLSL(
-struct VSIn { float2 pos : POSITION; float2 uv : TEXCOORD0; };
-struct VSOut { float4 pos : SV_POSITION; float2 uv : TEXCOORD0; };
+struct VSIn { float2 pos : POSITION; float2 uv : TEXCOORD0; float4 color : COLOR0; };
+struct VSOut { float4 pos : SV_POSITION; float2 uv : TEXCOORD0; float4 color : COLOR0; };
 cbuffer ScreenCB : register(b0) { float2 screenSize; float2 pad; };
 VSOut VSMain(VSIn i) {
     VSOut o;
     float2 ndc = float2(i.pos.x / (screenSize.x * 0.5f) - 1.0f,
                         -(i.pos.y / (screenSize.y * 0.5f) - 1.0f));
-    o.pos = float4(ndc, 0, 1); o.uv = i.uv;
+    o.pos = float4(ndc, 0, 1); o.uv = i.uv; o.color = i.color;
     return o;
 }
 
 Texture2D tex0 : register(t0); SamplerState samp0 : register(s0);
-float4 PSColor(VSOut i) : SV_Target { return float4(0.2, 0.7, 0.9, 1); }
-float4 PSTex(VSOut i) : SV_Target { return tex0.Sample(samp0, i.uv); }
+float4 PSColor(VSOut i) : SV_Target { return i.color; }
+float4 PSTex(VSOut i) : SV_Target { return tex0.Sample(samp0, i.uv) * i.color; }
 )HLSL";
 
 struct ScreenCB {
@@ -150,35 +158,31 @@ void D3D11Renderer::CreateSwapChainAndTargets(HWND hwnd, int w, int h) {
 }
 
 void D3D11Renderer::CreatePipeline() {
-    VertexPTC verts[] = {
-        {0, 0, 0, 0},
-        {96, 0, 1, 0},
-        {96, 96, 1, 1},
-        {0, 96, 0, 1},
-    };
-
-    uint16_t indices[] = {0, 1, 2, 0, 2, 3};
+    std::vector<uint16_t> indices(kMaxBatchQuads * 6);
+    for (UINT q = 0; q < kMaxBatchQuads; ++q) {
+        const uint16_t v = static_cast<uint16_t>(q * 4);
+        const uint16_t quad[6] = {v, uint16_t(v + 1), uint16_t(v + 2), v, uint16_t(v + 2), uint16_t(v + 3)};
+        std::memcpy(&indices[q * 6], quad, sizeof(quad));
+    }
 
     D3D11_BUFFER_DESC vbDesc{};
     vbDesc.Usage = D3D11_USAGE_DYNAMIC;
-    vbDesc.ByteWidth = sizeof(verts);
+    vbDesc.ByteWidth = kMaxBatchQuads * 4 * sizeof(VertexPTC);
     vbDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
     vbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-
-    D3D11_SUBRESOURCE_DATA vbData{};
-    vbData.pSysMem = verts;
     ThrowIfFailed(device_->CreateBuffer(&vbDesc,
-                                        &vbData,
+                                        nullptr,
                                         vb_.ReleaseAndGetAddressOf()),
                   "CreateBuffer (vertex) failed");
+    vbCursor_ = kMaxBatchQuads; // the first map discards
 
     D3D11_BUFFER_DESC ibDesc{};
     ibDesc.Usage = D3D11_USAGE_IMMUTABLE;
-    ibDesc.ByteWidth = sizeof(indices);
+    ibDesc.ByteWidth = static_cast<UINT>(indices.size() * sizeof(uint16_t));
     ibDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
 
     D3D11_SUBRESOURCE_DATA ibData{};
-    ibData.pSysMem = indices;
+    ibData.pSysMem = indices.data();
     ThrowIfFailed(device_->CreateBuffer(&ibDesc,
                                         &ibData,
                                         ib_.ReleaseAndGetAddressOf()),
@@ -196,6 +200,8 @@ void D3D11Renderer::CreatePipeline() {
          D3D11_INPUT_PER_VERTEX_DATA, 0},
         {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 8,
          D3D11_INPUT_PER_VERTEX_DATA, 0},
+        {"COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, 16,
+         D3D11_INPUT_PER_VERTEX_DATA, 0},
     };
     const UINT inputCount = static_cast<UINT>(sizeof(layoutDesc) / sizeof(layoutDesc[0]));
     ThrowIfFailed(device_->CreateInputLayout(layoutDesc,
@@ -237,11 +243,27 @@ void D3D11Renderer::CreatePipeline() {
     ThrowIfFailed(device_->CreateSamplerState(&samplerDesc,
                                               sampler_.ReleaseAndGetAddressOf()),
                   "CreateSamplerState failed");
+
+    // Straight alpha: sprites with transparent edges and glyph coverage.
+    D3D11_BLEND_DESC blendDesc{};
+    D3D11_RENDER_TARGET_BLEND_DESC& rt = blendDesc.RenderTarget[0];
+    rt.BlendEnable = TRUE;
+    rt.SrcBlend = D3D11_BLEND_SRC_ALPHA;
+    rt.DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+    rt.BlendOp = D3D11_BLEND_OP_ADD;
+    rt.SrcBlendAlpha = D3D11_BLEND_ONE;
+    rt.DestBlendAlpha = D3D11_BLEND_INV_SRC_ALPHA;
+    rt.BlendOpAlpha = D3D11_BLEND_OP_ADD;
+    rt.RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+    ThrowIfFailed(device_->CreateBlendState(&blendDesc,
+                                            blend_.ReleaseAndGetAddressOf()),
+                  "CreateBlendState failed");
 }
 
 void D3D11Renderer::BeginFrame(float r, float g, float b, float a) {
     float clear[4] = {r, g, b, a};
     context_->OMSetRenderTargets(1, rtv_.GetAddressOf(), nullptr);
+    context_->OMSetBlendState(blend_.Get(), nullptr, 0xFFFFFFFFu);
     context_->ClearRenderTargetView(rtv_.Get(), clear);
 
     D3D11_MAPPED_SUBRESOURCE mapped{};
@@ -269,59 +291,144 @@ void D3D11Renderer::BeginFrame(float r, float g, float b, float a) {
 }
 
 void D3D11Renderer::DrawQuad(float x, float y, float w, float h) {
-    D3D11_MAPPED_SUBRESOURCE mapped{};
-    ThrowIfFailed(context_->Map(vb_.Get(),
-                                0,
-                                D3D11_MAP_WRITE_DISCARD,
-                                0,
-                                &mapped),
-                  "Map VB failed");
-    auto* verts = static_cast<VertexPTC*>(mapped.pData);
-    verts[0] = {x, y, 0, 0};
-    verts[1] = {x + w, y, 1, 0};
-    verts[2] = {x + w, y + h, 1, 1};
-    verts[3] = {x, y + h, 0, 1};
-    context_->Unmap(vb_.Get(), 0);
-
-    context_->PSSetShader(psColor_.Get(), nullptr, 0);
-    context_->DrawIndexed(6, 0, 0);
+    SpriteQuad quad;
+    quad.x = x;
+    quad.y = y;
+    quad.w = w;
+    quad.h = h;
+    quad.color = kQuadColor;
+    DrawSprites(&quad, 1, nullptr);
 }
 
 void D3D11Renderer::DrawTexturedQuad(float x, float y, float w, float h, void* texture) {
+    SpriteQuad quad;
+    quad.x = x;
+    quad.y = y;
+    quad.w = w;
+    quad.h = h;
+    quad.color = kWhite;
+    DrawSprites(&quad, 1, texture);
+}
+
+VertexPTC* D3D11Renderer::MapQuads(UINT count, UINT& baseVertex) {
+    // Append behind earlier draws while the buffer has room (the GPU may
+    // still be reading those), and only discard when it is full.
+    D3D11_MAP mode = D3D11_MAP_WRITE_NO_OVERWRITE;
+    if (vbCursor_ + count > kMaxBatchQuads) {
+        mode = D3D11_MAP_WRITE_DISCARD;
+        vbCursor_ = 0;
+    }
     D3D11_MAPPED_SUBRESOURCE mapped{};
-    ThrowIfFailed(context_->Map(vb_.Get(),
-                                0,
-                                D3D11_MAP_WRITE_DISCARD,
-                                0,
-                                &mapped),
-                  "Map VB failed");
-    auto* verts = static_cast<VertexPTC*>(mapped.pData);
-    verts[0] = {x, y, 0, 0};
-    verts[1] = {x + w, y, 1, 0};
-    verts[2] = {x + w, y + h, 1, 1};
-    verts[3] = {x, y + h, 0, 1};
-    context_->Unmap(vb_.Get(), 0);
-
-    ID3D11ShaderResourceView* srv = static_cast<ID3D11ShaderResourceView*>(texture);
-    context_->PSSetShader(psTex_.Get(), nullptr, 0);
-    context_->PSSetShaderResources(0, 1, &srv);
-    context_->PSSetSamplers(0, 1, sampler_.GetAddressOf());
-    context_->DrawIndexed(6, 0, 0);
+    ThrowIfFailed(context_->Map(vb_.Get(), 0, mode, 0, &mapped), "Map VB failed");
+    baseVertex = vbCursor_ * 4;
+    vbCursor_ += count;
+    return static_cast<VertexPTC*>(mapped.pData) + baseVertex;
+}
+
+void D3D11Renderer::DrawSprites(const SpriteQuad* quads, size_t count, void* texture) {
+    if (texture) {
+        ID3D11ShaderResourceView* srv = static_cast<ID3D11ShaderResourceView*>(texture);
+        context_->PSSetShader(psTex_.Get(), nullptr, 0);
+        context_->PSSetShaderResources(0, 1, &srv);
+        context_->PSSetSamplers(0, 1, sampler_.GetAddressOf());
+    } else {
+        context_->PSSetShader(psColor_.Get(), nullptr, 0);
+    }
+
+    while (count > 0) {
+        const UINT batch = static_cast<UINT>(std::min<size_t>(count, kMaxBatchQuads));
+        UINT baseVertex = 0;
+        VertexPTC* v = MapQuads(batch, baseVertex);
+        for (UINT i = 0; i < batch; ++i, v += 4) {
+            const SpriteQuad& q = quads[i];
+            v[0] = {q.x, q.y, q.u0, q.v0, q.color};
+            v[1] = {q.x + q.w, q.y, q.u1, q.v0, q.color};
+            v[2] = {q.x + q.w, q.y + q.h, q.u1, q.v1, q.color};
+            v[3] = {q.x, q.y + q.h, q.u0, q.v1, q.color};
+        }
+        context_->Unmap(vb_.Get(), 0);
+        context_->DrawIndexed(batch * 6, 0, static_cast<INT>(baseVertex));
+        quads += batch;
+        count -= batch;
+    }
 }
 
 void* D3D11Renderer::LoadTextureFromFile(const char* path) {
     Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv;
-    HRESULT hr = CreateWICTextureFromFile(device_.Get(),
-                                          context_.Get(),
-                                          path,
-                                          nullptr,
-                                          srv.GetAddressOf());
+    HRESULT hr = CreateTextureFromFile(device_.Get(),
+                                       context_.Get(),
+                                       path,
+                                       nullptr,
+                                       srv.GetAddressOf());
     if (FAILED(hr)) {
         return nullptr;
     }
     return srv.Detach();
 }
 
+void* D3D11Renderer::CreateTexture(int width, int height, const uint8_t* rgba) {
+    D3D11_TEXTURE2D_DESC desc{};
+    desc.Width = static_cast<UINT>(width);
+    desc.Height = static_cast<UINT>(height);
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT; // UpdateSubresource-able
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+    D3D11_SUBRESOURCE_DATA data{};
+    data.pSysMem = rgba;
+    data.SysMemPitch = static_cast<UINT>(width) * 4;
+
+    ComPtr<ID3D11Texture2D> texture;
+    if (FAILED(device_->CreateTexture2D(&desc, rgba ? &data : nullptr, texture.GetAddressOf()))) {
+        return nullptr;
+    }
+    ComPtr<ID3D11ShaderResourceView> srv;
+    if (FAILED(device_->CreateShaderResourceView(texture.Get(), nullptr, srv.GetAddressOf()))) {
+        return nullptr;
+    }
+    textures_.push_back(srv);
+    return srv.Get();
+}
+
+void D3D11Renderer::UpdateTexture(void* texture, int x, int y, int width, int height,
+                                  const uint8_t* rgba, size_t pitch) {
+    if (!texture || width <= 0 || height <= 0) {
+        return;
+    }
+    ComPtr<ID3D11Resource> resource;
+    static_cast<ID3D11ShaderResourceView*>(texture)->GetResource(resource.GetAddressOf());
+    D3D11_BOX box{};
+    box.left = static_cast<UINT>(x);
+    box.top = static_cast<UINT>(y);
+    box.right = static_cast<UINT>(x + width);
+    box.bottom = static_cast<UINT>(y + height);
+    box.front = 0;
+    box.back = 1;
+    context_->UpdateSubresource(resource.Get(), 0, &box, rgba, static_cast<UINT>(pitch), 0);
+}
+
 void D3D11Renderer::EndFrame() {
-    swapChain_->Present(1, 0);
+    if (pacer_) {
+        pacer_->MarkPresentBegin();
+    }
+    swapChain_->Present(syncInterval_, 0);
+    if (pacer_) {
+        pacer_->EndFrame();
+    }
+    hasPresented_ = true;
+}
+
+bool D3D11Renderer::PresentPrevious() {
+    if (!hasPresented_) {
+        return false;
+    }
+    // Nothing is presented: the window keeps showing the last frame. The
+    // pacer waits out the skipped present so the loop keeps its cadence.
+    if (pacer_) {
+        pacer_->SkipFrame();
+    }
+    return true;
 }
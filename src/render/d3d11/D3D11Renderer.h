@@ -1,13 +1,16 @@
 #pragma once
 #include <d3d11.h>
 #include <wrl/client.h>
+#include <vector>
 #include "../../core/App.h"
+#include "../../core/FramePacer.h"
 
 using Microsoft::WRL::ComPtr;
 
 struct VertexPTC {
     float x, y;
     float u, v;
+    uint32_t color; // R8G8B8A8
 };
 
 class D3D11Renderer : public IRenderer2D {
@@ -19,15 +22,24 @@ public:
     void BeginFrame(float r, float g, float b, float a) override;
     void DrawQuad(float x, float y, float w, float h) override;
     void DrawTexturedQuad(float x, float y, float w, float h, void* texture) override;
+    void DrawSprites(const SpriteQuad* quads, size_t count, void* texture) override;
     void* LoadTextureFromFile(const char* path) override;
+    void* CreateTexture(int width, int height, const uint8_t* rgba) override;
+    void UpdateTexture(void* texture, int x, int y, int width, int height,
+                       const uint8_t* rgba, size_t pitch) override;
     void EndFrame() override;
+    bool PresentPrevious() override;
 
     ID3D11Device* GetDevice() const { return device_.Get(); }
     ID3D11DeviceContext* GetDeviceContext() const { return context_.Get(); }
 
+    void SetSyncInterval(UINT interval) { syncInterval_ = interval; }
+    void SetFramePacer(FramePacer* pacer) { pacer_ = pacer; }
+
 private:
     void CreateSwapChainAndTargets(HWND hwnd, int width, int height);
     void CreatePipeline();
+    VertexPTC* MapQuads(UINT count, UINT& baseVertex);
 
     ComPtr<ID3D11Device> device_;
     ComPtr<ID3D11DeviceContext> context_;
@@ -41,8 +53,14 @@ private:
     ComPtr<ID3D11Buffer> vb_;
     ComPtr<ID3D11Buffer> ib_;
     ComPtr<ID3D11SamplerState> sampler_;
+    ComPtr<ID3D11BlendState> blend_;
+    std::vector<ComPtr<ID3D11ShaderResourceView>> textures_; // from CreateTexture
     D3D11_VIEWPORT viewport_{};
 
     int backBufferW_ = 0;
     int backBufferH_ = 0;
+    UINT vbCursor_ = 0; // quads written since the last discard
+    bool hasPresented_ = false;
+    UINT syncInterval_ = 1;
+    FramePacer* pacer_ = nullptr;
 };
@@ -1,4 +1,5 @@
 #include "TextureLoader.h"
+#include "../../image/ImageDecoder.h"
 
 #include <wincodec.h>
 
@@ -14,6 +15,129 @@ static IWICImagingFactory* GetWICFactory() {
     return factory;
 }
 
+static HRESULT CreateShaderView(ID3D11Device* device,
+                                ComPtr<ID3D11Texture2D>& texture,
+                                ID3D11Resource** textureOut,
+                                ID3D11ShaderResourceView** srvOut) {
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+    srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MipLevels = 1;
+
+    ComPtr<ID3D11ShaderResourceView> srv;
+    HRESULT hr = device->CreateShaderResourceView(texture.Get(), &srvDesc, &srv);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    if (textureOut) {
+        *textureOut = texture.Detach();
+    }
+    if (srvOut) {
+        *srvOut = srv.Detach();
+    }
+    return S_OK;
+}
+
+static D3D11_TEXTURE2D_DESC TextureDesc(UINT width, UINT height) {
+    D3D11_TEXTURE2D_DESC textureDesc{};
+    textureDesc.Width = width;
+    textureDesc.Height = height;
+    textureDesc.MipLevels = 1;
+    textureDesc.ArraySize = 1;
+    textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.Usage = D3D11_USAGE_IMMUTABLE;
+    textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    return textureDesc;
+}
+
+static HRESULT CreateTextureFromPixels(ID3D11Device* device,
+                                       UINT width,
+                                       UINT height,
+                                       const void* pixels,
+                                       UINT pitch,
+                                       ID3D11Resource** textureOut,
+                                       ID3D11ShaderResourceView** srvOut) {
+    const D3D11_TEXTURE2D_DESC textureDesc = TextureDesc(width, height);
+
+    D3D11_SUBRESOURCE_DATA subData{};
+    subData.pSysMem = pixels;
+    subData.SysMemPitch = pitch;
+
+    ComPtr<ID3D11Texture2D> texture;
+    HRESULT hr = device->CreateTexture2D(&textureDesc, &subData, &texture);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    return CreateShaderView(device, texture, textureOut, srvOut);
+}
+
+// The decoder writes straight into a mapped staging texture, which the GPU
+// then copies into a default-usage one: no intermediate pixel vector, and no
+// CPU copy of the whole image into driver memory. E_FAIL means the decoder
+// rejected the file.
+static HRESULT CreateTextureByDecoding(ID3D11Device* device,
+                                       ID3D11DeviceContext* context,
+                                       const std::vector<uint8_t>& file,
+                                       const ImageInfo& info,
+                                       ID3D11Resource** textureOut,
+                                       ID3D11ShaderResourceView** srvOut) {
+    D3D11_TEXTURE2D_DESC stagingDesc = TextureDesc(static_cast<UINT>(info.width), static_cast<UINT>(info.height));
+    stagingDesc.Usage = D3D11_USAGE_STAGING;
+    stagingDesc.BindFlags = 0;
+    stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+    ComPtr<ID3D11Texture2D> staging;
+    HRESULT hr = device->CreateTexture2D(&stagingDesc, nullptr, &staging);
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped{};
+    hr = context->Map(staging.Get(), 0, D3D11_MAP_WRITE, 0, &mapped);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    const bool decoded =
+        DecodeImage(file.data(), file.size(), static_cast<uint8_t*>(mapped.pData), mapped.RowPitch);
+    context->Unmap(staging.Get(), 0);
+    if (!decoded) {
+        return E_FAIL;
+    }
+
+    D3D11_TEXTURE2D_DESC textureDesc = TextureDesc(stagingDesc.Width, stagingDesc.Height);
+    textureDesc.Usage = D3D11_USAGE_DEFAULT; // IMMUTABLE needs its data at creation
+
+    ComPtr<ID3D11Texture2D> texture;
+    hr = device->CreateTexture2D(&textureDesc, nullptr, &texture);
+    if (FAILED(hr)) {
+        return hr;
+    }
+    context->CopyResource(texture.Get(), staging.Get());
+    return CreateShaderView(device, texture, textureOut, srvOut);
+}
+
+HRESULT CreateTextureFromFile(ID3D11Device* device,
+                              ID3D11DeviceContext* context,
+                              const std::string& filename,
+                              ID3D11Resource** textureOut,
+                              ID3D11ShaderResourceView** srvOut) {
+    std::vector<uint8_t> file;
+    if (!ReadFileBytes(filename.c_str(), file)) {
+        return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+    }
+
+    ImageInfo info;
+    if (context && ReadImageInfo(file.data(), file.size(), info)) {
+        const HRESULT hr = CreateTextureByDecoding(device, context, file, info, textureOut, srvOut);
+        if (hr != E_FAIL) {
+            return hr;
+        }
+    }
+    return CreateWICTextureFromFile(device, context, filename, textureOut, srvOut);
+}
+
 HRESULT CreateWICTextureFromFile(ID3D11Device* device,
                                  ID3D11DeviceContext* context,
                                  const std::string& filename,
@@ -61,42 +185,5 @@ HRESULT CreateWICTextureFromFile(ID3D11Device* device,
         return hr;
     }
 
-    D3D11_TEXTURE2D_DESC textureDesc{};
-    textureDesc.Width = width;
-    textureDesc.Height = height;
-    textureDesc.MipLevels = 1;
-    textureDesc.ArraySize = 1;
-    textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    textureDesc.SampleDesc.Count = 1;
-    textureDesc.Usage = D3D11_USAGE_IMMUTABLE;
-    textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-
-    D3D11_SUBRESOURCE_DATA subData{};
-    subData.pSysMem = pixels.data();
-    subData.SysMemPitch = width * 4;
-
-    ComPtr<ID3D11Texture2D> texture;
-    hr = device->CreateTexture2D(&textureDesc, &subData, &texture);
-    if (FAILED(hr)) {
-        return hr;
-    }
-
-    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-    srvDesc.Format = textureDesc.Format;
-    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-    srvDesc.Texture2D.MipLevels = 1;
-
-    ComPtr<ID3D11ShaderResourceView> srv;
-    hr = device->CreateShaderResourceView(texture.Get(), &srvDesc, &srv);
-    if (FAILED(hr)) {
-        return hr;
-    }
-
-    if (textureOut) {
-        *textureOut = texture.Detach();
-    }
-    if (srvOut) {
-        *srvOut = srv.Detach();
-    }
-    return S_OK;
+    return CreateTextureFromPixels(device, width, height, pixels.data(), width * 4, textureOut, srvOut);
 }
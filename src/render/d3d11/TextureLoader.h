@@ -7,6 +7,14 @@
 
 using Microsoft::WRL::ComPtr;
 
+// QOI/PNG go through the portable decoder in src/image; anything it rejects
+// (JPEG, BMP, interlaced PNG, ...) falls back to WIC.
+HRESULT CreateTextureFromFile(ID3D11Device* device,
+                              ID3D11DeviceContext* context,
+                              const std::string& filename,
+                              ID3D11Resource** textureOut,
+                              ID3D11ShaderResourceView** srvOut);
+
 HRESULT CreateWICTextureFromFile(ID3D11Device* device,
                                  ID3D11DeviceContext* context,
                                  const std::string& filename,
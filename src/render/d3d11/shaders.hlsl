@@ -8,12 +8,14 @@ struct VSIn
 {
     float2 pos : POSITION;
     float2 uv  : TEXCOORD0;
+    float4 color : COLOR0;
 };
 
 struct VSOut
 {
     float4 pos : SV_POSITION;
     float2 uv  : TEXCOORD0;
+    float4 color : COLOR0;
 };
 
 VSOut VSMain(VSIn input)
@@ -23,6 +25,7 @@ VSOut VSMain(VSIn input)
                         -(input.pos.y / (screenSize.y * 0.5f) - 1.0f));
     output.pos = float4(ndc, 0.0f, 1.0f);
     output.uv = input.uv;
+    output.color = input.color;
     return output;
 }
 
@@ -31,10 +34,10 @@ SamplerState samp0 : register(s0);
 
 float4 PSColor(VSOut input) : SV_Target
 {
-    return float4(0.2f, 0.7f, 0.9f, 1.0f);
+    return input.color;
 }
 
 float4 PSTex(VSOut input) : SV_Target
 {
-    return tex0.Sample(samp0, input.uv);
+    return tex0.Sample(samp0, input.uv) * input.color;
 }
@@ -0,0 +1,56 @@
+#include "HeadlessRenderer.h"
+
+void HeadlessRenderer::BeginFrame(float, float, float, float) {}
+
+void HeadlessRenderer::DrawQuad(float, float, float, float) {
+    ++stats_.quads;
+}
+
+void HeadlessRenderer::DrawTexturedQuad(float, float, float, float, void*) {
+    ++stats_.quads;
+}
+
+void HeadlessRenderer::DrawSprites(const SpriteQuad*, size_t count, void*) {
+    stats_.quads += count;
+}
+
+void* HeadlessRenderer::LoadTextureFromFile(const char*) {
+    return nullptr;
+}
+
+void* HeadlessRenderer::CreateTexture(int width, int height, const uint8_t*) {
+    if (width <= 0 || height <= 0) {
+        return nullptr;
+    }
+    std::unique_ptr<Texture> texture(new Texture);
+    texture->width = width;
+    texture->height = height;
+    stats_.uploadedPixels += static_cast<uint64_t>(width) * height;
+    textures_.push_back(std::move(texture));
+    return textures_.back().get();
+}
+
+void HeadlessRenderer::UpdateTexture(void* texture, int, int, int width, int height,
+                                     const uint8_t*, size_t) {
+    if (!texture || width <= 0 || height <= 0) {
+        return;
+    }
+    stats_.uploadedPixels += static_cast<uint64_t>(width) * height;
+}
+
+void HeadlessRenderer::EndFrame() {
+    if (pacer_) {
+        pacer_->MarkPresentBegin();
+        pacer_->EndFrame();
+    }
+    ++stats_.framesPresented;
+}
+
+bool HeadlessRenderer::PresentPrevious() {
+    // Nothing on screen to keep: the frame is skipped entirely.
+    if (pacer_) {
+        pacer_->SkipFrame();
+    }
+    ++stats_.framesSkipped;
+    return true;
+}
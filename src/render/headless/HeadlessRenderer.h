@@ -0,0 +1,45 @@
+#pragma once
+#include "../../core/App.h"
+#include "../../core/FramePacer.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct HeadlessRenderStats {
+    uint64_t framesPresented = 0;
+    uint64_t framesSkipped = 0;
+    uint64_t quads = 0;
+    uint64_t uploadedPixels = 0;
+};
+
+// IRenderer2D without a window or GPU, for running App where nothing is
+// displayed (tests, bots). Draw calls are only counted. A frame identical to
+// the previous one is skipped outright, since there is no screen to refresh.
+class HeadlessRenderer : public IRenderer2D {
+public:
+    void SetFramePacer(FramePacer* pacer) { pacer_ = pacer; }
+    const HeadlessRenderStats& Stats() const { return stats_; }
+
+    // IRenderer2D
+    void BeginFrame(float r, float g, float b, float a) override;
+    void DrawQuad(float x, float y, float w, float h) override;
+    void DrawTexturedQuad(float x, float y, float w, float h, void* texture) override;
+    void DrawSprites(const SpriteQuad* quads, size_t count, void* texture) override;
+    void* LoadTextureFromFile(const char* path) override; // not loaded: always null
+    void* CreateTexture(int width, int height, const uint8_t* rgba) override;
+    void UpdateTexture(void* texture, int x, int y, int width, int height,
+                       const uint8_t* rgba, size_t pitch) override;
+    void EndFrame() override;
+    bool PresentPrevious() override;
+
+private:
+    struct Texture {
+        int width = 0;
+        int height = 0;
+    };
+
+    std::vector<std::unique_ptr<Texture>> textures_;
+    FramePacer* pacer_ = nullptr;
+    HeadlessRenderStats stats_;
+};
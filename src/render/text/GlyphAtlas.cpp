@@ -0,0 +1,214 @@
+#include "GlyphAtlas.h"
+#include "../../image/ImageDecoder.h"
+
+#include <algorithm>
+#include <cmath>
+
+// imgui_draw.cpp compiles its own static copy as well; STBTT_STATIC keeps the
+// two from clashing at link time.
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "imstb_truetype.h"
+
+namespace {
+
+// Transparent border around each glyph so linear filtering never picks up a
+// neighbour.
+constexpr int kPadding = 1;
+
+} // namespace
+
+struct GlyphAtlas::FontFace {
+    std::vector<uint8_t> data;
+    stbtt_fontinfo info{};
+    float scale = 0.0f;
+};
+
+GlyphAtlas::GlyphAtlas(int width, int height)
+    : width_(std::max(width, 1)), height_(std::max(height, 1)) {
+    pixels_.resize(Pitch() * height_);
+    Reset();
+}
+
+GlyphAtlas::~GlyphAtlas() = default;
+
+bool GlyphAtlas::LoadFont(const char* path, float pixelHeight) {
+    std::vector<uint8_t> ttf;
+    return ReadFileBytes(path, ttf) && LoadFont(std::move(ttf), pixelHeight);
+}
+
+bool GlyphAtlas::LoadFont(std::vector<uint8_t> ttf, float pixelHeight) {
+    auto face = std::make_unique<FontFace>();
+    face->data = std::move(ttf);
+    const unsigned char* data = face->data.data();
+    const int offset = face->data.empty() ? -1 : stbtt_GetFontOffsetForIndex(data, 0);
+    if (offset < 0 || pixelHeight <= 0.0f || !stbtt_InitFont(&face->info, data, offset)) {
+        return false;
+    }
+    face->scale = stbtt_ScaleForPixelHeight(&face->info, pixelHeight);
+
+    int ascent = 0;
+    int descent = 0;
+    int lineGap = 0;
+    stbtt_GetFontVMetrics(&face->info, &ascent, &descent, &lineGap);
+    pixelHeight_ = pixelHeight;
+    ascent_ = std::ceil(ascent * face->scale);
+    lineHeight_ = std::ceil((ascent - descent + lineGap) * face->scale);
+
+    face_ = std::move(face);
+    Reset();
+    return true;
+}
+
+void GlyphAtlas::Reset() {
+    for (size_t i = 0; i < pixels_.size(); i += 4) {
+        pixels_[i + 0] = 255;
+        pixels_[i + 1] = 255;
+        pixels_[i + 2] = 255;
+        pixels_[i + 3] = 0;
+    }
+    std::fill(std::begin(asciiLoaded_), std::end(asciiLoaded_), false);
+    glyphs_.clear();
+    glyphCount_ = 0;
+    shelves_.clear();
+    shelfBottom_ = 0;
+    full_ = false;
+    ++generation_;
+    MarkDirty(0, 0, width_, height_);
+}
+
+const Glyph* GlyphAtlas::Find(uint32_t codepoint) {
+    if (!face_) {
+        return nullptr;
+    }
+    if (codepoint < 128) {
+        if (asciiLoaded_[codepoint]) {
+            return &ascii_[codepoint];
+        }
+    } else {
+        auto it = glyphs_.find(codepoint);
+        if (it != glyphs_.end()) {
+            return &it->second;
+        }
+    }
+
+    const stbtt_fontinfo& info = face_->info;
+    const float scale = face_->scale;
+    Glyph g;
+    g.index = stbtt_FindGlyphIndex(&info, static_cast<int>(codepoint)); // 0 draws the font's missing-glyph box
+    int advance = 0;
+    int bearing = 0;
+    stbtt_GetGlyphHMetrics(&info, g.index, &advance, &bearing);
+    g.advance = advance * scale;
+
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = 0;
+    int y1 = 0;
+    stbtt_GetGlyphBitmapBox(&info, g.index, scale, scale, &x0, &y0, &x1, &y1);
+    const int w = x1 - x0;
+    const int h = y1 - y0;
+    if (w <= 0 || h <= 0) {
+        g.empty = true;
+    } else {
+        int ax = 0;
+        int ay = 0;
+        if (!Allocate(w + kPadding * 2, h + kPadding * 2, ax, ay)) {
+            full_ = true;
+            return nullptr;
+        }
+        ax += kPadding;
+        ay += kPadding;
+
+        scratch_.resize(static_cast<size_t>(w) * h);
+        stbtt_MakeGlyphBitmap(&info, scratch_.data(), w, h, w, scale, scale, g.index);
+        for (int row = 0; row < h; ++row) {
+            const uint8_t* src = scratch_.data() + static_cast<size_t>(row) * w;
+            uint8_t* dst = pixels_.data() + (ay + row) * Pitch() + ax * 4;
+            for (int col = 0; col < w; ++col) {
+                dst[col * 4 + 3] = src[col];
+            }
+        }
+        MarkDirty(ax, ay, w, h);
+
+        g.x0 = static_cast<float>(x0);
+        g.y0 = static_cast<float>(y0);
+        g.x1 = static_cast<float>(x1);
+        g.y1 = static_cast<float>(y1);
+        g.u0 = static_cast<float>(ax) / width_;
+        g.v0 = static_cast<float>(ay) / height_;
+        g.u1 = static_cast<float>(ax + w) / width_;
+        g.v1 = static_cast<float>(ay + h) / height_;
+    }
+
+    ++glyphCount_;
+    if (codepoint < 128) {
+        ascii_[codepoint] = g;
+        asciiLoaded_[codepoint] = true;
+        return &ascii_[codepoint];
+    }
+    return &glyphs_.emplace(codepoint, g).first->second;
+}
+
+float GlyphAtlas::Kerning(const Glyph& left, const Glyph& right) const {
+    if (!face_) {
+        return 0.0f;
+    }
+    return stbtt_GetGlyphKernAdvance(&face_->info, left.index, right.index) * face_->scale;
+}
+
+bool GlyphAtlas::Allocate(int w, int h, int& x, int& y) {
+    if (w > width_ || h > height_) {
+        return false;
+    }
+    // Best fit among shelves tall enough and with room left.
+    Shelf* best = nullptr;
+    for (Shelf& s : shelves_) {
+        if (h <= s.height && s.x + w <= width_ && (!best || s.height < best->height)) {
+            best = &s;
+        }
+    }
+    // Open a new shelf rather than waste most of a much taller one.
+    const bool wasteful = best && best->height > h + h / 2;
+    if ((!best || wasteful) && shelfBottom_ + h <= height_) {
+        shelves_.push_back({shelfBottom_, h, 0});
+        shelfBottom_ += h;
+        best = &shelves_.back();
+    }
+    if (!best) {
+        return false;
+    }
+    x = best->x;
+    y = best->y;
+    best->x += w;
+    return true;
+}
+
+void GlyphAtlas::MarkDirty(int x, int y, int w, int h) {
+    if (dirtyX1_ <= dirtyX0_) {
+        dirtyX0_ = x;
+        dirtyY0_ = y;
+        dirtyX1_ = x + w;
+        dirtyY1_ = y + h;
+        return;
+    }
+    dirtyX0_ = std::min(dirtyX0_, x);
+    dirtyY0_ = std::min(dirtyY0_, y);
+    dirtyX1_ = std::max(dirtyX1_, x + w);
+    dirtyY1_ = std::max(dirtyY1_, y + h);
+}
+
+bool GlyphAtlas::Dirty(AtlasRegion& region) const {
+    if (dirtyX1_ <= dirtyX0_ || dirtyY1_ <= dirtyY0_) {
+        return false;
+    }
+    region.x = dirtyX0_;
+    region.y = dirtyY0_;
+    region.w = dirtyX1_ - dirtyX0_;
+    region.h = dirtyY1_ - dirtyY0_;
+    return true;
+}
+
+void GlyphAtlas::ClearDirty() {
+    dirtyX0_ = dirtyY0_ = dirtyX1_ = dirtyY1_ = 0;
+}
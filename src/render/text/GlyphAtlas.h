@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+struct Glyph {
+    // Quad relative to the pen position on the baseline, in pixels.
+    float x0 = 0.0f;
+    float y0 = 0.0f;
+    float x1 = 0.0f;
+    float y1 = 0.0f;
+    float u0 = 0.0f;
+    float v0 = 0.0f;
+    float u1 = 0.0f;
+    float v1 = 0.0f;
+    float advance = 0.0f;
+    int index = 0;       // font glyph index, for kerning
+    bool empty = false;  // nothing to draw (e.g. space)
+};
+
+struct AtlasRegion {
+    int x = 0;
+    int y = 0;
+    int w = 0;
+    int h = 0;
+};
+
+// One font at one pixel size, rasterized into a shared RGBA8 atlas on first
+// use of each codepoint. Pixels are white with coverage in alpha, so glyphs
+// draw through the ordinary tinted sprite path. Space is handed out by a
+// shelf packer; glyphs never move, so their UVs stay valid until Reset.
+class GlyphAtlas {
+public:
+    GlyphAtlas(int width = 1024, int height = 1024);
+    ~GlyphAtlas();
+
+    bool LoadFont(const char* path, float pixelHeight);
+    bool LoadFont(std::vector<uint8_t> ttf, float pixelHeight);
+    bool HasFont() const { return face_ != nullptr; }
+
+    float PixelHeight() const { return pixelHeight_; }
+    float Ascent() const { return ascent_; }
+    float LineHeight() const { return lineHeight_; }
+
+    // Rasterizes the glyph if needed. Returns null when it does not fit; the
+    // atlas is then Full() until Reset.
+    const Glyph* Find(uint32_t codepoint);
+    float Kerning(const Glyph& left, const Glyph& right) const;
+
+    // Drops every glyph and bumps the generation, invalidating all UVs
+    // handed out so far.
+    void Reset();
+    bool Full() const { return full_; }
+    uint64_t Generation() const { return generation_; }
+    size_t GlyphCount() const { return glyphCount_; }
+
+    int Width() const { return width_; }
+    int Height() const { return height_; }
+    const uint8_t* Pixels() const { return pixels_.data(); }
+    size_t Pitch() const { return static_cast<size_t>(width_) * 4; }
+
+    // Bounding box of pixels written since the last ClearDirty.
+    bool Dirty(AtlasRegion& region) const;
+    void ClearDirty();
+
+private:
+    struct FontFace;
+    struct Shelf {
+        int y;
+        int height;
+        int x;
+    };
+
+    bool Allocate(int w, int h, int& x, int& y);
+    void MarkDirty(int x, int y, int w, int h);
+
+    int width_;
+    int height_;
+    std::vector<uint8_t> pixels_;
+    std::vector<uint8_t> scratch_; // 8-bit coverage before expanding to RGBA
+
+    std::unique_ptr<FontFace> face_;
+    float pixelHeight_ = 0.0f;
+    float ascent_ = 0.0f;
+    float lineHeight_ = 0.0f;
+
+    Glyph ascii_[128];
+    bool asciiLoaded_[128] = {};
+    std::unordered_map<uint32_t, Glyph> glyphs_; // beyond ASCII
+    size_t glyphCount_ = 0;
+
+    std::vector<Shelf> shelves_;
+    int shelfBottom_ = 0;
+    bool full_ = false;
+    uint64_t generation_ = 1;
+
+    int dirtyX0_ = 0;
+    int dirtyY0_ = 0;
+    int dirtyX1_ = 0;
+    int dirtyY1_ = 0;
+};
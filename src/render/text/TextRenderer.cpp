@@ -0,0 +1,202 @@
+#include "TextRenderer.h"
+#include "../FrameHash.h"
+#include "../../core/App.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr uint32_t kReplacementChar = 0xFFFD;
+
+// If one frame's text overflows a freshly reset atlas, resetting again cannot
+// help; wait this long before the next try instead of re-rasterizing and
+// re-uploading the whole atlas every frame.
+constexpr uint64_t kMinFramesBetweenResets = 60;
+
+// Decodes one codepoint at text[i] and advances i. Malformed sequences
+// yield U+FFFD and skip a single byte.
+uint32_t DecodeUtf8(std::string_view text, size_t& i) {
+    const uint8_t b0 = static_cast<uint8_t>(text[i]);
+    if (b0 < 0x80) {
+        ++i;
+        return b0;
+    }
+    int extra = 0;
+    uint32_t cp = 0;
+    if ((b0 & 0xE0) == 0xC0) {
+        extra = 1;
+        cp = b0 & 0x1F;
+    } else if ((b0 & 0xF0) == 0xE0) {
+        extra = 2;
+        cp = b0 & 0x0F;
+    } else if ((b0 & 0xF8) == 0xF0) {
+        extra = 3;
+        cp = b0 & 0x07;
+    } else {
+        ++i;
+        return kReplacementChar;
+    }
+    if (i + extra >= text.size()) {
+        ++i;
+        return kReplacementChar;
+    }
+    for (int k = 1; k <= extra; ++k) {
+        const uint8_t b = static_cast<uint8_t>(text[i + k]);
+        if ((b & 0xC0) != 0x80) {
+            ++i;
+            return kReplacementChar;
+        }
+        cp = (cp << 6) | (b & 0x3F);
+    }
+    i += extra + 1;
+    return cp;
+}
+
+} // namespace
+
+TextRenderer::TextRenderer(int atlasWidth, int atlasHeight)
+    : atlas_(atlasWidth, atlasHeight) {}
+
+bool TextRenderer::LoadFont(const char* path, float pixelHeight) {
+    if (!atlas_.LoadFont(path, pixelHeight)) {
+        return false;
+    }
+    layouts_.clear();
+    lastReset_ = frame_;
+    return true;
+}
+
+void TextRenderer::Draw(float x, float y, std::string_view text, uint32_t color) {
+    if (text.empty() || !atlas_.HasFont()) {
+        return;
+    }
+    const Layout& layout = GetLayout(text);
+    // Whole-pixel origins keep glyphs aligned with the texels they were
+    // rasterized into.
+    const float ox = std::round(x);
+    const float oy = std::round(y);
+    const size_t base = quads_.size();
+    quads_.resize(base + layout.quads.size());
+    SpriteQuad* out = quads_.data() + base;
+    for (const SpriteQuad& q : layout.quads) {
+        *out = q;
+        out->x += ox;
+        out->y += oy;
+        out->color = color;
+        ++out;
+    }
+}
+
+float TextRenderer::Measure(std::string_view text) {
+    if (text.empty() || !atlas_.HasFont()) {
+        return 0.0f;
+    }
+    return GetLayout(text).width;
+}
+
+const TextRenderer::Layout& TextRenderer::GetLayout(std::string_view text) {
+    Layout& layout = layouts_[HashBytes(text.data(), text.size())];
+    layout.lastUsed = frame_;
+    if (layout.generation == atlas_.Generation() && layout.text == text) {
+        ++stats_.layoutHits;
+        return layout;
+    }
+    // New string, a hash collision, or UVs from before an atlas reset.
+    ++stats_.layoutMisses;
+    Shape(text, layout);
+    return layout;
+}
+
+void TextRenderer::Shape(std::string_view text, Layout& layout) {
+    layout.text.assign(text.data(), text.size());
+    layout.quads.clear();
+    layout.width = 0.0f;
+
+    bool complete = true;
+    float penX = 0.0f;
+    float baseline = atlas_.Ascent();
+    const Glyph* prev = nullptr;
+    for (size_t i = 0; i < text.size();) {
+        const uint32_t cp = DecodeUtf8(text, i);
+        if (cp == '\n') {
+            layout.width = std::max(layout.width, penX);
+            penX = 0.0f;
+            baseline += atlas_.LineHeight();
+            prev = nullptr;
+            continue;
+        }
+        if (cp == '\r') {
+            continue;
+        }
+        const Glyph* g = atlas_.Find(cp);
+        if (!g) {
+            complete = false; // atlas full; retried after the reset in Record
+            prev = nullptr;
+            continue;
+        }
+        if (prev) {
+            penX += atlas_.Kerning(*prev, *g);
+        }
+        if (!g->empty) {
+            SpriteQuad q;
+            q.x = std::round(penX) + g->x0;
+            q.y = baseline + g->y0;
+            q.w = g->x1 - g->x0;
+            q.h = g->y1 - g->y0;
+            q.u0 = g->u0;
+            q.v0 = g->v0;
+            q.u1 = g->u1;
+            q.v1 = g->v1;
+            layout.quads.push_back(q);
+        }
+        penX += g->advance;
+        prev = g;
+    }
+    layout.width = std::max(layout.width, penX);
+    layout.generation = complete ? atlas_.Generation() : 0;
+}
+
+void TextRenderer::Record(DrawList& list, IRenderer2D& renderer) {
+    stats_.quads = quads_.size();
+    if (!quads_.empty()) {
+        AtlasRegion dirty;
+        if (!texture_) {
+            texture_ = renderer.CreateTexture(atlas_.Width(), atlas_.Height(), atlas_.Pixels());
+            atlas_.ClearDirty();
+        } else if (atlas_.Dirty(dirty)) {
+            const uint8_t* first = atlas_.Pixels() + dirty.y * atlas_.Pitch() + dirty.x * 4;
+            renderer.UpdateTexture(texture_, dirty.x, dirty.y, dirty.w, dirty.h, first, atlas_.Pitch());
+            atlas_.ClearDirty();
+        }
+        if (texture_) {
+            list.Sprites(quads_.data(), quads_.size(), texture_, atlas_.Generation());
+        }
+    }
+    quads_.clear();
+
+    // Glyphs that did not fit are missing until the reset; the frame after
+    // it rasterizes just what is still on screen.
+    if (atlas_.Full() && frame_ - lastReset_ >= kMinFramesBetweenResets) {
+        atlas_.Reset();
+        lastReset_ = frame_;
+        ++stats_.atlasResets;
+    }
+    Evict();
+    stats_.cachedLayouts = layouts_.size();
+    stats_.glyphs = atlas_.GlyphCount();
+    ++frame_;
+}
+
+void TextRenderer::Evict() {
+    if (layouts_.size() <= capacity_) {
+        return;
+    }
+    for (auto it = layouts_.begin(); it != layouts_.end();) {
+        if (it->second.lastUsed != frame_) {
+            it = layouts_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "GlyphAtlas.h"
+#include "../DrawList.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class IRenderer2D;
+
+struct TextStats {
+    uint64_t layoutHits = 0;
+    uint64_t layoutMisses = 0;
+    uint64_t atlasResets = 0;
+    size_t cachedLayouts = 0;
+    size_t glyphs = 0;  // resident in the atlas
+    size_t quads = 0;   // last recorded frame
+};
+
+// Collects every label drawn during a frame and records them as a single
+// sprite command on the glyph atlas. Shaped layouts (glyph quads relative to
+// the string's origin) are cached by content, so drawing a string seen
+// recently costs a hash lookup and a copy of its quads; only new strings are
+// shaped and only new codepoints are rasterized.
+class TextRenderer {
+public:
+    explicit TextRenderer(int atlasWidth = 1024, int atlasHeight = 1024);
+
+    bool LoadFont(const char* path, float pixelHeight);
+    bool HasFont() const { return atlas_.HasFont(); }
+    float LineHeight() const { return atlas_.LineHeight(); }
+
+    // (x, y) is the top-left of the first line; '\n' starts a new line. The
+    // text is UTF-8.
+    void Draw(float x, float y, std::string_view text, uint32_t color = 0xFFFFFFFFu);
+    float Measure(std::string_view text); // width of the widest line
+
+    // Uploads newly rasterized glyphs, records this frame's text into list
+    // and starts collecting the next frame.
+    void Record(DrawList& list, IRenderer2D& renderer);
+
+    // Layouts not used in the current frame are dropped once the cache
+    // holds more than this many.
+    void SetCacheCapacity(size_t layouts) { capacity_ = layouts; }
+    const TextStats& Stats() const { return stats_; }
+
+private:
+    struct Layout {
+        std::string text;
+        uint64_t generation = 0; // atlas generation the UVs belong to; 0 = incomplete
+        std::vector<SpriteQuad> quads;
+        float width = 0.0f;
+        uint64_t lastUsed = 0;
+    };
+
+    const Layout& GetLayout(std::string_view text);
+    void Shape(std::string_view text, Layout& layout);
+    void Evict();
+
+    GlyphAtlas atlas_;
+    void* texture_ = nullptr;
+    std::unordered_map<uint64_t, Layout> layouts_;
+    std::vector<SpriteQuad> quads_;
+    size_t capacity_ = 4096;
+    uint64_t frame_ = 1;
+    uint64_t lastReset_ = 0;
+    TextStats stats_;
+};
@@ -0,0 +1,296 @@
+#include "TransformHierarchy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+constexpr uint32_t kNoSlot = 0xFFFFFFFFu;
+
+// Below this many nodes per thread, spawning threads costs more than it saves.
+constexpr size_t kMinNodesPerThread = 16384;
+
+} // namespace
+
+Affine2D Affine2D::FromTransform(const Transform2D& t) {
+    const float cs = std::cos(t.rotation);
+    const float sn = std::sin(t.rotation);
+    Affine2D m;
+    m.a = cs * t.scaleX;
+    m.b = sn * t.scaleX;
+    m.c = -sn * t.scaleY;
+    m.d = cs * t.scaleY;
+    m.tx = t.x;
+    m.ty = t.y;
+    return m;
+}
+
+Affine2D operator*(const Affine2D& p, const Affine2D& c) {
+    Affine2D m;
+    m.a = p.a * c.a + p.c * c.b;
+    m.b = p.b * c.a + p.d * c.b;
+    m.c = p.a * c.c + p.c * c.d;
+    m.d = p.b * c.c + p.d * c.d;
+    m.tx = p.a * c.tx + p.c * c.ty + p.tx;
+    m.ty = p.b * c.tx + p.d * c.ty + p.ty;
+    return m;
+}
+
+TransformId TransformHierarchy::Create(TransformId parent) {
+    TransformId id;
+    if (!freeIds_.empty()) {
+        id = freeIds_.back();
+        freeIds_.pop_back();
+        nodes_[id] = Node();
+    } else {
+        id = static_cast<TransformId>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    nodes_[id].alive = true;
+    Link(id, parent);
+    structureDirty_ = true;
+    return id;
+}
+
+void TransformHierarchy::Destroy(TransformId id) {
+    if (id >= nodes_.size() || !nodes_[id].alive) {
+        return;
+    }
+    Unlink(id);
+    // Free the subtree iteratively; deep chains would overflow a recursion.
+    std::vector<TransformId> stack{id};
+    while (!stack.empty()) {
+        const TransformId n = stack.back();
+        stack.pop_back();
+        for (TransformId c = nodes_[n].firstChild; c != kInvalidTransform; c = nodes_[c].nextSibling) {
+            stack.push_back(c);
+        }
+        nodes_[n].alive = false;
+        freeIds_.push_back(n);
+    }
+    structureDirty_ = true;
+}
+
+void TransformHierarchy::SetParent(TransformId id, TransformId parent) {
+    if (id >= nodes_.size() || !nodes_[id].alive || nodes_[id].parent == parent) {
+        return;
+    }
+    if (parent != kInvalidTransform && (parent >= nodes_.size() || !nodes_[parent].alive)) {
+        return;
+    }
+    // Refuse to create a cycle.
+    for (TransformId p = parent; p != kInvalidTransform; p = nodes_[p].parent) {
+        if (p == id) {
+            return;
+        }
+    }
+    Unlink(id);
+    Link(id, parent);
+    structureDirty_ = true;
+}
+
+void TransformHierarchy::Link(TransformId id, TransformId parent) {
+    Node& n = nodes_[id];
+    if (parent != kInvalidTransform && (parent >= nodes_.size() || !nodes_[parent].alive)) {
+        parent = kInvalidTransform;
+    }
+    n.parent = parent;
+    TransformId& head = parent == kInvalidTransform ? firstRoot_ : nodes_[parent].firstChild;
+    n.nextSibling = head;
+    head = id;
+}
+
+void TransformHierarchy::Unlink(TransformId id) {
+    Node& n = nodes_[id];
+    TransformId* link = n.parent == kInvalidTransform ? &firstRoot_ : &nodes_[n.parent].firstChild;
+    while (*link != kInvalidTransform && *link != id) {
+        link = &nodes_[*link].nextSibling;
+    }
+    if (*link == id) {
+        *link = n.nextSibling;
+    }
+    n.parent = kInvalidTransform;
+    n.nextSibling = kInvalidTransform;
+}
+
+void TransformHierarchy::SetLocal(TransformId id, const Transform2D& local) {
+    if (id >= nodes_.size() || !nodes_[id].alive) {
+        return;
+    }
+    Node& n = nodes_[id];
+    n.local = local;
+    if (structureDirty_) {
+        return; // the next Flatten copies every local and recomputes everything
+    }
+    local_[n.slot] = Affine2D::FromTransform(local);
+    if (!dirty_[n.slot]) {
+        dirty_[n.slot] = 1;
+        dirtySlots_.push_back(n.slot);
+    }
+}
+
+const Transform2D& TransformHierarchy::Local(TransformId id) const {
+    static const Transform2D kDefault;
+    return id < nodes_.size() && nodes_[id].alive ? nodes_[id].local : kDefault;
+}
+
+const Affine2D& TransformHierarchy::World(TransformId id) const {
+    static const Affine2D kIdentity;
+    if (id >= nodes_.size() || !nodes_[id].alive) {
+        return kIdentity;
+    }
+    const Node& n = nodes_[id];
+    return n.slot < world_.size() && order_[n.slot] == id ? world_[n.slot] : kIdentity;
+}
+
+void TransformHierarchy::Flatten() {
+    const size_t count = nodes_.size() - freeIds_.size();
+    order_.clear();
+    order_.reserve(count);
+    local_.resize(count);
+    world_.resize(count);
+    parentSlot_.resize(count);
+    subtreeEnd_.resize(count);
+    dirty_.assign(count, 0);
+    dirtySlots_.clear();
+
+    // Explicit-stack pre-order walk. A node's subtree ends where the walk
+    // first returns to a slot outside it, which is patched in on the way out.
+    struct Frame {
+        TransformId id;
+        uint32_t slot;
+    };
+    std::vector<Frame> stack;
+    for (TransformId root = firstRoot_; root != kInvalidTransform; root = nodes_[root].nextSibling) {
+        stack.push_back({root, kNoSlot});
+        while (!stack.empty()) {
+            Frame f = stack.back();
+            if (f.slot != kNoSlot) {
+                subtreeEnd_[f.slot] = static_cast<uint32_t>(order_.size());
+                stack.pop_back();
+                continue;
+            }
+            const uint32_t slot = static_cast<uint32_t>(order_.size());
+            Node& n = nodes_[f.id];
+            n.slot = slot;
+            order_.push_back(f.id);
+            local_[slot] = Affine2D::FromTransform(n.local);
+            parentSlot_[slot] = n.parent == kInvalidTransform ? kNoSlot : nodes_[n.parent].slot;
+            stack.back().slot = slot;
+            for (TransformId c = n.firstChild; c != kInvalidTransform; c = nodes_[c].nextSibling) {
+                stack.push_back({c, kNoSlot});
+            }
+        }
+    }
+    structureDirty_ = false;
+}
+
+void TransformHierarchy::UpdateRange(uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; ++i) {
+        const uint32_t p = parentSlot_[i];
+        world_[i] = p == kNoSlot ? local_[i] : world_[p] * local_[i];
+    }
+}
+
+void TransformHierarchy::SplitForThreads(std::vector<Range>& ranges, size_t total, unsigned threads) {
+    // Break large subtrees into their children's subtrees (after computing
+    // the subtree root here) until the work can be spread evenly.
+    const size_t target = std::max(total / (threads * 4), kMinNodesPerThread);
+    for (size_t i = 0; i < ranges.size();) {
+        const Range r = ranges[i];
+        if (r.end - r.begin <= target || r.end - r.begin == 1) {
+            ++i;
+            continue;
+        }
+        UpdateRange(r.begin, r.begin + 1);
+        ranges[i] = ranges.back();
+        ranges.pop_back();
+        for (uint32_t c = r.begin + 1; c < r.end; c = subtreeEnd_[c]) {
+            ranges.push_back({c, subtreeEnd_[c]});
+        }
+    }
+}
+
+void TransformHierarchy::Update() {
+    ranges_.clear();
+    if (structureDirty_) {
+        Flatten();
+        for (uint32_t s = 0; s < order_.size(); s = subtreeEnd_[s]) {
+            ranges_.push_back({s, subtreeEnd_[s]});
+        }
+    } else if (dirtySlots_.size() * 8 > order_.size()) {
+        // Most of the hierarchy changed: one linear pass over the flags beats
+        // sorting the dirty list.
+        for (uint32_t s = 0; s < order_.size();) {
+            if (dirty_[s]) {
+                ranges_.push_back({s, subtreeEnd_[s]});
+                s = subtreeEnd_[s];
+            } else {
+                ++s;
+            }
+        }
+        std::fill(dirty_.begin(), dirty_.end(), 0);
+        dirtySlots_.clear();
+    } else {
+        // Sorted slots make nested dirty nodes adjacent to their dirty
+        // ancestor, whose subtree range already covers them.
+        std::sort(dirtySlots_.begin(), dirtySlots_.end());
+        uint32_t coveredEnd = 0;
+        for (uint32_t s : dirtySlots_) {
+            dirty_[s] = 0;
+            if (s < coveredEnd) {
+                continue;
+            }
+            coveredEnd = subtreeEnd_[s];
+            ranges_.push_back({s, coveredEnd});
+        }
+        dirtySlots_.clear();
+    }
+
+    size_t total = 0;
+    for (const Range& r : ranges_) {
+        total += r.end - r.begin;
+    }
+    lastUpdated_ = total;
+
+    const unsigned maxThreads = maxThreads_ ? maxThreads_ : std::max(1u, std::thread::hardware_concurrency());
+    const unsigned threads = static_cast<unsigned>(
+        std::min<size_t>(maxThreads, total / kMinNodesPerThread));
+    if (threads <= 1) {
+        for (const Range& r : ranges_) {
+            UpdateRange(r.begin, r.end);
+        }
+        return;
+    }
+
+    SplitForThreads(ranges_, total, threads);
+
+    // Largest-first greedy assignment to the least loaded thread.
+    std::sort(ranges_.begin(), ranges_.end(), [](const Range& a, const Range& b) {
+        return a.end - a.begin > b.end - b.begin;
+    });
+    std::vector<std::vector<Range>> buckets(threads);
+    std::vector<size_t> load(threads, 0);
+    for (const Range& r : ranges_) {
+        const size_t t = std::min_element(load.begin(), load.end()) - load.begin();
+        buckets[t].push_back(r);
+        load[t] += r.end - r.begin;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) {
+        workers.emplace_back([this, &buckets, t] {
+            for (const Range& r : buckets[t]) {
+                UpdateRange(r.begin, r.end);
+            }
+        });
+    }
+    for (const Range& r : buckets[0]) {
+        UpdateRange(r.begin, r.end);
+    }
+    for (std::thread& w : workers) {
+        w.join();
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Transform2D {
+    float x = 0.0f;
+    float y = 0.0f;
+    float rotation = 0.0f; // radians
+    float scaleX = 1.0f;
+    float scaleY = 1.0f;
+};
+
+// x' = a * x + c * y + tx
+// y' = b * x + d * y + ty
+struct Affine2D {
+    float a = 1.0f;
+    float b = 0.0f;
+    float c = 0.0f;
+    float d = 1.0f;
+    float tx = 0.0f;
+    float ty = 0.0f;
+
+    static Affine2D FromTransform(const Transform2D& t);
+};
+
+Affine2D operator*(const Affine2D& parent, const Affine2D& child);
+
+using TransformId = uint32_t;
+constexpr TransformId kInvalidTransform = 0xFFFFFFFFu;
+
+// Parent/child 2D transforms. Nodes live in flat arrays in pre-order, so
+// every parent precedes its children and each subtree is one contiguous
+// range. Update() only walks the subtrees under nodes changed since the last
+// update, making its cost proportional to what moved rather than to the
+// size of the hierarchy; independent subtrees are spread across threads
+// when there is enough work.
+//
+// Structural edits (Create/Destroy/SetParent) re-flatten the arrays on the
+// next Update, which then recomputes everything once.
+class TransformHierarchy {
+public:
+    TransformId Create(TransformId parent = kInvalidTransform);
+    void Destroy(TransformId id); // and its whole subtree; ids are recycled
+    void SetParent(TransformId id, TransformId parent); // ignored for dead parents and cycles
+
+    // Dead or unknown ids are ignored by edits; reads return the default
+    // transform and the identity.
+    void SetLocal(TransformId id, const Transform2D& local);
+    const Transform2D& Local(TransformId id) const;
+    const Affine2D& World(TransformId id) const; // as of the last Update
+
+    void Update();
+
+    void SetMaxThreads(unsigned count) { maxThreads_ = count; } // 0 = hardware threads
+    size_t Size() const { return order_.size(); }
+    size_t LastUpdatedCount() const { return lastUpdated_; }
+
+private:
+    struct Node {
+        Transform2D local;
+        TransformId parent = kInvalidTransform;
+        TransformId firstChild = kInvalidTransform;
+        TransformId nextSibling = kInvalidTransform;
+        uint32_t slot = 0; // index into the flat arrays
+        bool alive = false;
+    };
+
+    struct Range {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    void Link(TransformId id, TransformId parent);
+    void Unlink(TransformId id);
+    void Flatten();
+    void UpdateRange(uint32_t begin, uint32_t end);
+    void SplitForThreads(std::vector<Range>& ranges, size_t total, unsigned threads);
+
+    // Id-indexed; stable across structural edits.
+    std::vector<Node> nodes_;
+    std::vector<TransformId> freeIds_;
+    TransformId firstRoot_ = kInvalidTransform;
+
+    // Slot-indexed, pre-order.
+    std::vector<TransformId> order_;
+    std::vector<Affine2D> local_;  // composed at SetLocal, so Update only multiplies
+    std::vector<Affine2D> world_;
+    std::vector<uint32_t> parentSlot_; // UINT32_MAX for roots
+    std::vector<uint32_t> subtreeEnd_;
+    std::vector<uint8_t> dirty_;
+
+    std::vector<uint32_t> dirtySlots_;
+    std::vector<Range> ranges_;
+    bool structureDirty_ = false;
+    unsigned maxThreads_ = 0;
+    size_t lastUpdated_ = 0;
+};
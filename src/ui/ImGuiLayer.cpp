@@ -4,6 +4,8 @@
 #include "backends/imgui_impl_dx11.h"
 #include "backends/imgui_impl_win32.h"
 
+#include "../render/FrameHash.h"
+
 #include <cstdarg>
 
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam);
@@ -37,19 +39,58 @@ void ImGuiLayer::Begin() {
 }
 
 void ImGuiLayer::Text(const char* fmt, ...) {
-    ImGui::Begin("Stats");
+    if (!begun_) {
+        return;
+    }
+    // One "Stats" window per frame, closed in End().
+    if (!statsOpen_) {
+        ImGui::Begin("Stats");
+        statsOpen_ = true;
+    }
     va_list args;
     va_start(args, fmt);
     ImGui::TextV(fmt, args);
     va_end(args);
-    ImGui::End();
 }
 
 void ImGuiLayer::End() {
     if (!begun_) {
         return;
     }
+    if (statsOpen_) {
+        ImGui::End();
+        statsOpen_ = false;
+    }
     ImGui::Render();
-    ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
     begun_ = false;
+    hasDrawData_ = true;
+    ++frameCounter_;
+
+    const ImDrawData* data = ImGui::GetDrawData();
+    uint64_t h = HashValue(data->DisplaySize, kFrameHashSeed);
+    for (int i = 0; i < data->CmdListsCount; ++i) {
+        const ImDrawList* list = data->CmdLists[i];
+        h = HashBytes(list->VtxBuffer.Data, list->VtxBuffer.Size * sizeof(ImDrawVert), h);
+        h = HashBytes(list->IdxBuffer.Data, list->IdxBuffer.Size * sizeof(ImDrawIdx), h);
+        for (const ImDrawCmd& cmd : list->CmdBuffer) {
+            if (cmd.UserCallback) {
+                // Callback output is opaque; never treat this frame as a repeat.
+                h = HashValue(frameCounter_, h);
+                continue;
+            }
+            h = HashValue(cmd.ClipRect, h);
+            h = HashValue(cmd.GetTexID(), h);
+            h = HashValue(cmd.ElemCount, h);
+            h = HashValue(cmd.IdxOffset, h);
+            h = HashValue(cmd.VtxOffset, h);
+        }
+    }
+    fingerprint_ = h;
+}
+
+void ImGuiLayer::Draw() {
+    if (!hasDrawData_) {
+        return;
+    }
+    ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
 }
@@ -1,8 +1,9 @@
 #pragma once
 #include <windows.h>
 #include <d3d11.h>
+#include "../core/App.h"
 
-class ImGuiLayer {
+class ImGuiLayer : public IFrameOverlay {
 public:
     ImGuiLayer(HWND hwnd, ID3D11Device* dev, ID3D11DeviceContext* ctx);
     ~ImGuiLayer();
@@ -10,8 +11,16 @@ public:
     bool WndProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam);
     void Begin();
     void Text(const char* fmt, ...);
-    void End();
+    void End(); // finalizes draw data; it is drawn later through App's overlay slot
+
+    // IFrameOverlay
+    uint64_t Fingerprint() const override { return fingerprint_; }
+    void Draw() override;
 
 private:
     bool begun_ = false;
+    bool statsOpen_ = false;
+    bool hasDrawData_ = false;
+    uint64_t fingerprint_ = 0;
+    uint64_t frameCounter_ = 0;
 };
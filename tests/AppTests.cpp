@@ -0,0 +1,48 @@
+// App's frame loop on the headless renderer: unchanged frames are skipped
+// without drawing, changed ones are recorded and presented.
+#include "../src/core/App.h"
+#include "../src/render/headless/HeadlessRenderer.h"
+#include "TestCheck.h"
+
+#include <cstdio>
+
+namespace {
+
+void TestIdleFramesSkipped() {
+    AppConfig cfg;
+    App app(cfg);
+    HeadlessRenderer renderer;
+    app.SetRenderer(&renderer);
+
+    for (int i = 0; i < 10; ++i) {
+        app.Update(1.0f / 60.0f);
+        app.Render();
+    }
+    CHECK(app.Stats().submitted == 1);
+    CHECK(app.Stats().skipped == 9);
+    CHECK(renderer.Stats().framesPresented == 1);
+    CHECK(renderer.Stats().framesSkipped == 9);
+    const uint64_t quads = renderer.Stats().quads;
+
+    app.State().playerX += 10.0f;
+    app.Update(1.0f / 60.0f);
+    app.Render();
+    CHECK(app.Stats().submitted == 2);
+    CHECK(renderer.Stats().framesPresented == 2);
+    CHECK(renderer.Stats().quads > quads);
+
+    app.Update(1.0f / 60.0f);
+    app.Render();
+    CHECK(app.Stats().skipped == 10);
+
+    app.InvalidateFrame();
+    app.Render();
+    CHECK(app.Stats().submitted == 3);
+}
+
+} // namespace
+
+int main() {
+    TestIdleFramesSkipped();
+    return ReportFailures("AppTests");
+}
@@ -0,0 +1,105 @@
+// Flipbook sampling for each loop mode, uneven frame durations, and the
+// bounds of ApplyUvs.
+#include "../src/anim/Flipbook.h"
+#include "../src/render/DrawList.h"
+#include "TestCheck.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+// Frame i of a clip built by Frames() has u0 == i.
+std::vector<FlipbookFrame> Frames(std::initializer_list<float> durations) {
+    std::vector<FlipbookFrame> frames;
+    for (float d : durations) {
+        FlipbookFrame f;
+        f.uv.u0 = static_cast<float>(frames.size());
+        f.duration = d;
+        frames.push_back(f);
+    }
+    return frames;
+}
+
+int FrameAfter(FlipbookAnimator& a, uint32_t index, float dt) {
+    a.Sample(dt);
+    return static_cast<int>(a.Uvs()[index].u0);
+}
+
+void TestLoopModes() {
+    FlipbookLibrary lib;
+    const auto frames = Frames({0.1f, 0.1f, 0.1f, 0.1f});
+    const ClipId loop = lib.AddClip(frames.data(), frames.size(), FlipbookLoop::Loop);
+    const ClipId once = lib.AddClip(frames.data(), frames.size(), FlipbookLoop::Once);
+    const ClipId pingPong = lib.AddClip(frames.data(), frames.size(), FlipbookLoop::PingPong);
+
+    FlipbookAnimator a(lib);
+    const uint32_t l = a.Add(loop);
+    const uint32_t o = a.Add(once);
+    const uint32_t p = a.Add(pingPong);
+
+    const int expectLoop[] = {0, 1, 2, 3, 0, 1, 2, 3, 0, 1};
+    const int expectOnce[] = {0, 1, 2, 3, 3, 3, 3, 3, 3, 3};
+    const int expectPingPong[] = {0, 1, 2, 3, 3, 2, 1, 0, 0, 1};
+    for (int step = 0; step < 10; ++step) {
+        a.Sample(step == 0 ? 0.05f : 0.1f); // sample mid-frame
+        CHECK(static_cast<int>(a.Uvs()[l].u0) == expectLoop[step]);
+        CHECK(static_cast<int>(a.Uvs()[o].u0) == expectOnce[step]);
+        CHECK(static_cast<int>(a.Uvs()[p].u0) == expectPingPong[step]);
+    }
+    CHECK(a.Finished(o));
+    CHECK(!a.Finished(l));
+
+    CHECK(a.Add(12345) == FlipbookAnimator::kInvalidIndex);
+    CHECK(!a.Play(l, 12345));
+}
+
+void TestUnevenDurations() {
+    FlipbookLibrary lib;
+    const auto frames = Frames({0.1f, 0.3f, 0.1f});
+    const ClipId clip = lib.AddClip(frames.data(), frames.size(), FlipbookLoop::Once);
+    FlipbookAnimator a(lib);
+    const uint32_t i = a.Add(clip);
+    CHECK(FrameAfter(a, i, 0.05f) == 0);
+    CHECK(FrameAfter(a, i, 0.1f) == 1);  // 0.15
+    CHECK(FrameAfter(a, i, 0.2f) == 1);  // 0.35
+    CHECK(FrameAfter(a, i, 0.1f) == 2);  // 0.45
+    CHECK(FrameAfter(a, i, 1.0f) == 2);  // held
+}
+
+void TestApplyUvsBounds() {
+    FlipbookLibrary lib;
+    const ClipId clip = lib.AddGridClip(4, 1, 0, 4, 0.1f, FlipbookLoop::Loop);
+    FlipbookAnimator a(lib);
+    for (int i = 0; i < 4; ++i) {
+        a.Add(clip, 1.0f, i * 0.1f + 0.05f);
+    }
+    a.Sample(0.0f);
+
+    // Fewer quads than instances: only those are written.
+    std::vector<SpriteQuad> few(2);
+    a.ApplyUvs(few.data(), few.size());
+    CHECK(few[0].u0 == 0.0f && few[1].u0 == 0.25f);
+
+    // More quads than instances: the rest keep their UVs.
+    std::vector<SpriteQuad> many(6);
+    for (SpriteQuad& q : many) {
+        q.u0 = -1.0f;
+        q.x = 7.0f;
+    }
+    a.ApplyUvs(many.data(), many.size());
+    CHECK(many[3].u0 == 0.75f && many[3].u1 == 1.0f);
+    CHECK(many[4].u0 == -1.0f && many[5].u0 == -1.0f);
+    CHECK(many[0].x == 7.0f);
+
+    a.ApplyUvs(nullptr, 0);
+}
+
+} // namespace
+
+int main() {
+    TestLoopModes();
+    TestUnevenDurations();
+    TestApplyUvsBounds();
+    return ReportFailures("FlipbookTests");
+}
@@ -0,0 +1,296 @@
+// Drives FramePacer with a scripted clock: every timestamp is decided by the
+// test, so pacing decisions can be checked exactly on any platform.
+#include "../src/core/FramePacer.h"
+#include "TestCheck.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+// Time only moves when the test advances it or the pacer sleeps.
+class ScriptedClock : public IFrameClock {
+public:
+    double Now() override { return now_; }
+    void SleepUntil(double t) override {
+        sleeps.push_back(t);
+        if (t > now_) {
+            now_ = t;
+        }
+    }
+    void Advance(double seconds) { now_ += seconds; }
+
+    std::vector<double> sleeps;
+
+private:
+    double now_ = 100.0;
+};
+
+void TestTargetRateDeadlines() {
+    ScriptedClock clock;
+    FramePacerConfig cfg;
+    cfg.targetHz = 100.0;
+    FramePacer pacer(clock, cfg);
+
+    std::vector<double> starts;
+    for (int i = 0; i < 20; ++i) {
+        pacer.BeginFrame();
+        starts.push_back(clock.Now());
+        clock.Advance(0.003); // work well under the 10 ms period
+        pacer.MarkPresentBegin();
+        pacer.EndFrame();
+    }
+    for (size_t i = 1; i < starts.size(); ++i) {
+        CHECK_NEAR(starts[i] - starts[i - 1], 0.01, 1e-9);
+    }
+    // No drift: frame n starts n periods after the first.
+    CHECK_NEAR(starts.back() - starts.front(), 0.01 * (starts.size() - 1), 1e-9);
+    CHECK_NEAR(pacer.SmoothedDt(), 0.01, 1e-6);
+}
+
+// Every sleep overshoots its target by a fixed amount, as real timers do.
+class OversleepingClock : public ScriptedClock {
+public:
+    explicit OversleepingClock(double oversleep) : oversleep_(oversleep) {}
+    void SleepUntil(double t) override { ScriptedClock::SleepUntil(t + oversleep_); }
+
+private:
+    double oversleep_;
+};
+
+// Oversleep delays each frame by the same amount; it must not add up.
+void TestTargetRateOversleep() {
+    OversleepingClock clock(0.0005);
+    FramePacerConfig cfg;
+    cfg.targetHz = 100.0;
+    FramePacer pacer(clock, cfg);
+
+    std::vector<double> starts;
+    for (int i = 0; i < 1000; ++i) {
+        pacer.BeginFrame();
+        starts.push_back(clock.Now());
+        clock.Advance(0.003);
+        pacer.MarkPresentBegin();
+        pacer.EndFrame();
+    }
+    // Frame 0 never sleeps, so the grid as seen after oversleep starts at
+    // frame 1.
+    const double first = starts[1];
+    CHECK_NEAR(first - starts[0], 0.01 + 0.0005, 1e-9);
+    for (size_t n = 1; n < starts.size(); ++n) {
+        CHECK_NEAR(starts[n], first + 0.01 * (n - 1), 1e-6);
+    }
+}
+
+// A stall restarts the grid: the late frame is followed at once, then the
+// rate resumes without a burst of short frames.
+void TestTargetRateStall() {
+    ScriptedClock clock;
+    FramePacerConfig cfg;
+    cfg.targetHz = 100.0;
+    FramePacer pacer(clock, cfg);
+
+    std::vector<double> starts;
+    for (int i = 0; i < 10; ++i) {
+        pacer.BeginFrame();
+        starts.push_back(clock.Now());
+        clock.Advance(i == 4 ? 0.05 : 0.003);
+        pacer.MarkPresentBegin();
+        pacer.EndFrame();
+    }
+    CHECK_NEAR(starts[5] - starts[4], 0.05, 1e-9);
+    for (size_t i = 6; i < starts.size(); ++i) {
+        CHECK_NEAR(starts[i] - starts[i - 1], 0.01, 1e-9);
+    }
+}
+
+void TestHitchRejection() {
+    ScriptedClock clock;
+    FramePacer pacer(clock); // no limiter: dt is whatever the script spends
+
+    const double normal = 1.0 / 60.0;
+    auto frame = [&](double dt) {
+        const float smoothed = pacer.BeginFrame();
+        clock.Advance(dt);
+        pacer.EndFrame();
+        return smoothed;
+    };
+
+    frame(normal); // first frame reports no dt
+    for (int i = 0; i < 8; ++i) {
+        frame(normal);
+    }
+    CHECK_NEAR(pacer.SmoothedDt(), normal, 1e-6);
+    CHECK(pacer.OutliersRejected() == 0);
+
+    frame(0.25); // a hitch longer than maxDt
+    const float afterHitch = frame(normal);
+    CHECK_NEAR(pacer.RawDt(), 0.25, 1e-6);
+    CHECK_NEAR(afterHitch, normal, 1e-6); // clamped to 0.1, then rejected against the median
+    CHECK(pacer.OutliersRejected() == 1);
+
+    const float next = frame(normal);
+    CHECK_NEAR(next, normal, 1e-6);
+
+    // A sustained rate change is not a hitch: once it holds the median it
+    // becomes the new normal.
+    const double slow = 1.0 / 30.0;
+    for (int i = 0; i < 9; ++i) {
+        frame(slow);
+    }
+    CHECK_NEAR(pacer.BeginFrame(), slow, 1e-6);
+    CHECK(pacer.OutliersRejected() == 1);
+}
+
+void TestLowLatencyWakePoint() {
+    ScriptedClock clock;
+    FramePacerConfig cfg;
+    cfg.targetHz = 60.0;
+    cfg.lowLatency = true;
+    cfg.latencyMargin = 0.001;
+    FramePacer pacer(clock, cfg);
+
+    const double period = 1.0 / 60.0;
+    const double work = 0.004;
+    double firstPresent = 0.0;
+    for (int i = 0; i < 30; ++i) {
+        const size_t sleepsBefore = clock.sleeps.size();
+        pacer.BeginFrame();
+        if (i >= 2) {
+            // deadline - predicted work - margin, with the deadline on the
+            // grid started by the first present.
+            CHECK(clock.sleeps.size() == sleepsBefore + 1);
+            const double deadline = firstPresent + period * i;
+            CHECK_NEAR(pacer.PredictedWork(), work, 1e-9);
+            CHECK_NEAR(clock.sleeps.back(), deadline - work - cfg.latencyMargin, 1e-9);
+            CHECK(clock.Now() + work <= deadline);
+        }
+        clock.Advance(work);
+        pacer.MarkPresentBegin();
+        clock.Advance(0.0002); // Present itself
+        pacer.EndFrame();
+        if (i == 0) {
+            firstPresent = clock.Now();
+        }
+    }
+}
+
+// Present blocks until the next 60 Hz vblank; skipped frames must keep that
+// cadence rather than spin.
+void TestSkipFrameVsync() {
+    ScriptedClock clock;
+    FramePacer pacer(clock);
+    const double vblank = 1.0 / 60.0;
+    auto present = [&] {
+        pacer.MarkPresentBegin();
+        const double next = (std::floor(clock.Now() / vblank) + 1.0) * vblank;
+        clock.Advance(next - clock.Now());
+        pacer.EndFrame();
+    };
+
+    for (int i = 0; i < 10; ++i) {
+        pacer.BeginFrame();
+        clock.Advance(0.003);
+        present();
+    }
+    std::vector<double> starts;
+    for (int i = 0; i < 10; ++i) {
+        pacer.BeginFrame();
+        starts.push_back(clock.Now());
+        clock.Advance(0.001); // deciding to skip
+        pacer.SkipFrame();
+    }
+    for (size_t i = 1; i < starts.size(); ++i) {
+        CHECK_NEAR(starts[i] - starts[i - 1], vblank, 1e-6);
+    }
+    CHECK_NEAR(pacer.SmoothedDt(), vblank, 1e-6);
+    CHECK_NEAR(pacer.PresentInterval(), vblank, 1e-6); // not polluted by skips
+
+    // Presenting again lands back on the display's cadence.
+    pacer.BeginFrame();
+    clock.Advance(0.003);
+    present();
+    pacer.BeginFrame();
+    CHECK_NEAR(clock.Now() - starts.back(), 2 * vblank, 1e-6);
+}
+
+// With a limiter the deadline grid already paces skipped frames.
+void TestSkipFrameTargetRate() {
+    ScriptedClock clock;
+    FramePacerConfig cfg;
+    cfg.targetHz = 100.0;
+    FramePacer pacer(clock, cfg);
+
+    std::vector<double> starts;
+    for (int i = 0; i < 20; ++i) {
+        pacer.BeginFrame();
+        starts.push_back(clock.Now());
+        clock.Advance(0.002);
+        if (i < 5 || i % 3 == 0) {
+            pacer.MarkPresentBegin();
+            pacer.EndFrame();
+        } else {
+            const size_t sleeps = clock.sleeps.size();
+            pacer.SkipFrame();
+            CHECK(clock.sleeps.size() == sleeps);
+        }
+    }
+    for (size_t i = 1; i < starts.size(); ++i) {
+        CHECK_NEAR(starts[i] - starts[i - 1], 0.01, 1e-9);
+    }
+}
+
+void TestLatencyStats() {
+    ScriptedClock clock;
+    FramePacer pacer(clock);
+
+    // Latencies of 1..200 ms, input sampled at BeginFrame.
+    for (int i = 1; i <= 200; ++i) {
+        pacer.BeginFrame();
+        clock.Advance(i * 0.001);
+        pacer.EndFrame();
+    }
+    LatencyStats s = pacer.Latency();
+    CHECK(s.samples == 200);
+    CHECK_NEAR(s.minMs, 1.0, 1e-6);
+    CHECK_NEAR(s.maxMs, 200.0, 1e-6);
+    CHECK_NEAR(s.avgMs, 100.5, 1e-6);
+    CHECK_NEAR(s.p99Ms, 199.0, 1e-6);
+    CHECK_NEAR(s.lastMs, 200.0, 1e-6);
+
+    // The history is a 240-frame window: after 300 frames only 61..300 remain.
+    for (int i = 201; i <= 300; ++i) {
+        pacer.BeginFrame();
+        clock.Advance(i * 0.001);
+        pacer.EndFrame();
+    }
+    s = pacer.Latency();
+    CHECK(s.samples == 240);
+    CHECK_NEAR(s.minMs, 61.0, 1e-6);
+    CHECK_NEAR(s.maxMs, 300.0, 1e-6);
+    CHECK_NEAR(s.p99Ms, 298.0, 1e-6);
+    CHECK_NEAR(s.lastMs, 300.0, 1e-6);
+
+    // Input sampled late shortens the measured latency accordingly.
+    pacer.BeginFrame();
+    clock.Advance(0.010);
+    pacer.MarkInputSampled();
+    clock.Advance(0.002);
+    pacer.EndFrame();
+    CHECK_NEAR(pacer.Latency().lastMs, 2.0, 1e-6);
+}
+
+} // namespace
+
+int main() {
+    TestTargetRateDeadlines();
+    TestTargetRateOversleep();
+    TestTargetRateStall();
+    TestHitchRejection();
+    TestLowLatencyWakePoint();
+    TestSkipFrameVsync();
+    TestSkipFrameTargetRate();
+    TestLatencyStats();
+    return ReportFailures("FramePacerTests");
+}
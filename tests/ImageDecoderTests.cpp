@@ -0,0 +1,204 @@
+// QOI and PNG decoding against small hand-built files: valid images covering
+// every QOI op and the PNG Sub/Up/Avg/Paeth filters, and malformed streams
+// that must fail cleanly.
+#include "../src/image/ImageDecoder.h"
+#include "../src/image/PngDecoder.h"
+#include "../src/image/QoiDecoder.h"
+#include "TestCheck.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+// 4x4 RGBA8; rows filtered Sub, Up, Avg, Paeth. Pixels follow ExpectedPixel.
+const uint8_t kFilteredPng[] = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x08, 0x06, 0x00, 0x00, 0x00, 0xa9, 0xf1, 0x9e,
+    0x7e, 0x00, 0x00, 0x00, 0x42, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x64, 0x60, 0x60, 0xf8,
+    0x6f, 0xcb, 0x2b, 0xcb, 0x60, 0xcb, 0x1b, 0x0e, 0xc4, 0x13, 0x19, 0x98, 0x04, 0x13, 0xd9, 0x19,
+    0x80, 0xf8, 0x2b, 0x10, 0xbf, 0x02, 0xe2, 0xfb, 0xcc, 0x52, 0x93, 0xb8, 0x1b, 0xd4, 0xcd, 0x85,
+    0x3e, 0xa8, 0x9b, 0xeb, 0xbf, 0x52, 0x37, 0x3f, 0xf3, 0x94, 0x05, 0xac, 0x82, 0x17, 0xa8, 0x82,
+    0x17, 0xa8, 0x82, 0x97, 0xfd, 0x3e, 0x00, 0x14, 0x87, 0x11, 0x52, 0x84, 0xfa, 0x58, 0x93, 0x00,
+    0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+
+// 4x4 RGBA8 whose single dynamic block declares HLIT=31 (288 literal/length
+// codes) and HDIST=31 (32 distance codes), then fills the code lengths with
+// repeat code 18 three times (138 + 138 + 44 = 320 entries).
+const uint8_t kOversizedTablesPng[] = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x08, 0x06, 0x00, 0x00, 0x00, 0xa9, 0xf1, 0x9e,
+    0x7e, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x44, 0x41, 0x54, 0x78, 0x01, 0xfd, 0x1f, 0x80, 0xe4, 0xff,
+    0x7f, 0x08, 0x00, 0x00, 0x00, 0x00, 0x94, 0xaa, 0xc8, 0x43, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+    0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+
+// 4x3 RGBA; one op per pixel except the run, in raster order.
+const uint8_t kAllOpsQoi[] = {
+    'q', 'o', 'i', 'f', 0, 0, 0, 4, 0, 0, 0, 3, 4, 0,
+    0xFE, 10, 20, 30,         // RGB
+    0xFF, 200, 100, 50, 128,  // RGBA
+    0x76,                     // DIFF +1 -1 +0
+    0xAA, 0x5D,               // LUMA dg +10, dr-dg -3, db-dg +5
+    0x09,                     // INDEX of (10, 20, 30, 255)
+    0xC2,                     // RUN of 3
+    0x2A,                     // INDEX of (200, 100, 50, 128)
+    0x4C,                     // DIFF -2 +1 -2
+    0xFE, 255, 0, 1,          // RGB, alpha kept
+    0x78,                     // DIFF +1 +0 -2, wrapping red and blue
+    0, 0, 0, 0, 0, 0, 0, 1,
+};
+
+const uint8_t kAllOpsPixels[12][4] = {
+    {10, 20, 30, 255},   {200, 100, 50, 128}, {201, 99, 50, 128}, {208, 109, 65, 128},
+    {10, 20, 30, 255},   {10, 20, 30, 255},   {10, 20, 30, 255},  {10, 20, 30, 255},
+    {200, 100, 50, 128}, {198, 101, 48, 128}, {255, 0, 1, 128},   {0, 0, 255, 128},
+};
+
+void ExpectedPixel(int x, int y, uint8_t out[4]) {
+    out[0] = static_cast<uint8_t>(x * 61 + y * 17);
+    out[1] = static_cast<uint8_t>(x * 13 + y * 97);
+    out[2] = static_cast<uint8_t>(x * x * 29 + y * 7);
+    out[3] = static_cast<uint8_t>(255 - x * y * 11);
+}
+
+void TestQoiOps() {
+    ImageInfo info;
+    std::vector<uint8_t> rgba;
+    CHECK(DecodeImage(kAllOpsQoi, sizeof(kAllOpsQoi), info, rgba));
+    CHECK(info.format == ImageFormat::Qoi);
+    CHECK(info.width == 4 && info.height == 3);
+    CHECK(rgba.size() == 4 * 3 * 4);
+    if (rgba.size() != 4 * 3 * 4) {
+        return;
+    }
+    for (int i = 0; i < 12; ++i) {
+        for (int c = 0; c < 4; ++c) {
+            if (rgba[i * 4 + c] != kAllOpsPixels[i][c]) {
+                std::printf("qoi pixel %d channel %d: %d, want %d\n", i, c, rgba[i * 4 + c], kAllOpsPixels[i][c]);
+                ++g_testFailures;
+            }
+        }
+    }
+
+    // Every prefix loses ops or padding. Copies are exactly n bytes.
+    for (size_t n = 0; n < sizeof(kAllOpsQoi); ++n) {
+        std::vector<uint8_t> copy(kAllOpsQoi, kAllOpsQoi + n);
+        CHECK(!DecodeImage(copy.data(), copy.size(), info, rgba));
+    }
+
+    auto corrupt = [&](size_t offset, uint8_t value) {
+        std::vector<uint8_t> copy(kAllOpsQoi, kAllOpsQoi + sizeof(kAllOpsQoi));
+        copy[offset] = value;
+        std::vector<uint8_t> out(4 * 3 * 4);
+        return !QoiDecode(copy.data(), copy.size(), out.data(), 16) &&
+               !DecodeImage(copy.data(), copy.size(), info, rgba);
+    };
+    CHECK(corrupt(0, 'x'));  // magic
+    CHECK(corrupt(7, 0));    // zero width
+    CHECK(corrupt(12, 5));   // channel count
+    CHECK(corrupt(sizeof(kAllOpsQoi) - 9, 0xFF)); // RGBA op running into the padding
+}
+
+void TestFilteredPng() {
+    ImageInfo info;
+    std::vector<uint8_t> rgba;
+    CHECK(DecodeImage(kFilteredPng, sizeof(kFilteredPng), info, rgba));
+    CHECK(info.format == ImageFormat::Png);
+    CHECK(info.width == 4 && info.height == 4);
+    CHECK(rgba.size() == 4 * 4 * 4);
+    if (rgba.size() != 4 * 4 * 4) {
+        return;
+    }
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            uint8_t want[4];
+            ExpectedPixel(x, y, want);
+            const uint8_t* got = &rgba[(y * 4 + x) * 4];
+            for (int c = 0; c < 4; ++c) {
+                if (got[c] != want[c]) {
+                    std::printf("pixel (%d,%d) channel %d: %d, want %d\n", x, y, c, got[c], want[c]);
+                    ++g_testFailures;
+                }
+            }
+        }
+    }
+
+    // A padded destination pitch must leave the padding untouched.
+    std::vector<uint8_t> padded(4 * 24, 0xAB);
+    CHECK(DecodeImage(kFilteredPng, sizeof(kFilteredPng), padded.data(), 24));
+    bool same = true;
+    for (int y = 0; y < 4; ++y) {
+        for (int i = 0; i < 16; ++i) {
+            same = same && padded[y * 24 + i] == rgba[y * 16 + i];
+        }
+        for (int i = 16; i < 24; ++i) {
+            same = same && padded[y * 24 + i] == 0xAB;
+        }
+    }
+    CHECK(same);
+
+    // The scalar unfilter routines agree with the SIMD ones.
+    std::vector<uint8_t> scalar(rgba.size(), 0);
+    CHECK(PngDecode(kFilteredPng, sizeof(kFilteredPng), scalar.data(), 16, false));
+    CHECK(scalar == rgba);
+}
+
+void TestOversizedDynamicTables() {
+    ImageInfo info;
+    std::vector<uint8_t> rgba;
+    CHECK(ReadImageInfo(kOversizedTablesPng, sizeof(kOversizedTablesPng), info));
+    CHECK(!DecodeImage(kOversizedTablesPng, sizeof(kOversizedTablesPng), info, rgba));
+}
+
+void TestTruncated() {
+    // Prefixes cut before the end of the IDAT chunk fail; a missing IEND
+    // is tolerated. Copies are exactly n bytes, so sanitizers catch overreads.
+    const size_t idatEnd = 33 + 12 + 0x42;
+    for (size_t n = 0; n < sizeof(kFilteredPng); ++n) {
+        std::vector<uint8_t> copy(kFilteredPng, kFilteredPng + n);
+        ImageInfo info;
+        std::vector<uint8_t> rgba;
+        const bool ok = DecodeImage(copy.data(), copy.size(), info, rgba);
+        CHECK(n >= idatEnd || !ok);
+    }
+}
+
+// IHDR dimensions are checked before the inflate buffer is sized from them.
+void TestHugeDimensions() {
+    auto withSize = [](uint32_t width, uint32_t height) {
+        std::vector<uint8_t> copy(kFilteredPng, kFilteredPng + sizeof(kFilteredPng));
+        for (int i = 0; i < 4; ++i) {
+            copy[16 + i] = static_cast<uint8_t>(width >> (24 - 8 * i));
+            copy[20 + i] = static_cast<uint8_t>(height >> (24 - 8 * i));
+        }
+        return copy;
+    };
+    int width = 0;
+    int height = 0;
+    uint8_t dst[16 * 4] = {};
+    const std::vector<uint8_t> edge = withSize(kMaxImageDimension, 1);
+    CHECK(PngReadInfo(edge.data(), edge.size(), width, height));
+    CHECK(width == kMaxImageDimension && height == 1);
+    for (uint32_t side : {uint32_t(kMaxImageDimension + 1), 0x7FFFFFFFu}) {
+        const std::vector<uint8_t> wide = withSize(side, 4);
+        const std::vector<uint8_t> tall = withSize(4, side);
+        const std::vector<uint8_t> both = withSize(side, side);
+        CHECK(!PngReadInfo(wide.data(), wide.size(), width, height));
+        CHECK(!PngDecode(wide.data(), wide.size(), dst, 16));
+        CHECK(!PngDecode(tall.data(), tall.size(), dst, 16));
+        CHECK(!PngDecode(both.data(), both.size(), dst, 16));
+    }
+}
+
+} // namespace
+
+int main() {
+    TestQoiOps();
+    TestFilteredPng();
+    TestOversizedDynamicTables();
+    TestTruncated();
+    TestHugeDimensions();
+    return ReportFailures("ImageDecoderTests");
+}
@@ -0,0 +1,277 @@
+// Server/client replication over the loopback transport: interest, budget
+// prioritization and timeouts, plus a client transport that loses chosen
+// acks so baseline handling can be checked deterministically.
+#include "../src/net/LoopbackTransport.h"
+#include "../src/net/Replication.h"
+#include "TestCheck.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+// Wire constants, mirrored from Replication.cpp.
+constexpr uint8_t kMsgInput = 3;
+constexpr uint8_t kMsgSnapshot = 4;
+constexpr uint8_t kEntryRemoved = 1;
+
+// Client-side transport: records which snapshots carried an entry for
+// `watch` and drops the input packet acking the first one matching the
+// armed condition.
+class AckDroppingTransport : public INetTransport {
+public:
+    AckDroppingTransport(INetTransport& inner, uint32_t watch) : inner_(inner), watch_(watch) {}
+
+    // Drops the ack of the next snapshot carrying `watch` as a removal
+    // (removed = true) or as an update (removed = false).
+    void Arm(bool removed) {
+        armed_ = true;
+        armRemoved_ = removed;
+        dropSeq_ = 0;
+    }
+    int Dropped() const { return dropped_; }
+
+    PeerId LocalId() const override { return inner_.LocalId(); }
+
+    bool Send(PeerId to, const void* data, size_t size) override {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        if (dropSeq_ != 0 && size >= 5 && bytes[0] == kMsgInput) {
+            uint32_t ack = 0;
+            std::memcpy(&ack, bytes + 1, 4);
+            if (ack == dropSeq_) {
+                ++dropped_;
+                return true;
+            }
+        }
+        return inner_.Send(to, data, size);
+    }
+
+    bool Receive(NetPacket& out) override {
+        if (!inner_.Receive(out)) {
+            return false;
+        }
+        if (armed_ && !out.data.empty() && out.data[0] == kMsgSnapshot) {
+            Inspect(out.data);
+        }
+        return true;
+    }
+
+private:
+    void Inspect(const std::vector<uint8_t>& d) {
+        size_t pos = 1;
+        uint32_t seq = 0;
+        uint16_t count = 0;
+        std::memcpy(&seq, d.data() + pos, 4);
+        pos += 4 + 4; // seq, server time
+        std::memcpy(&count, d.data() + pos, 2);
+        pos += 2;
+        for (uint16_t i = 0; i < count && pos + 5 <= d.size(); ++i) {
+            uint32_t id = 0;
+            std::memcpy(&id, d.data() + pos, 4);
+            const bool removed = (d[pos + 4] & kEntryRemoved) != 0;
+            pos += 5 + (removed ? 0 : 8);
+            if (id == watch_ && removed == armRemoved_) {
+                dropSeq_ = seq;
+                armed_ = false;
+                return;
+            }
+        }
+    }
+
+    INetTransport& inner_;
+    uint32_t watch_;
+    bool armed_ = false;
+    bool armRemoved_ = false;
+    uint32_t dropSeq_ = 0;
+    int dropped_ = 0;
+};
+
+struct Harness {
+    explicit Harness(const ReplicationConfig& config = ReplicationConfig()) : cfg(config) {}
+
+    LoopbackNetwork network;
+    std::unique_ptr<LoopbackTransport> serverTransport = network.CreateEndpoint();
+    std::unique_ptr<LoopbackTransport> clientTransport = network.CreateEndpoint();
+    ReplicationConfig cfg;
+    ReplicationServer server{*serverTransport, cfg};
+    float centerX = cfg.worldWidth * 0.5f; // where the client's player spawns
+    float centerY = cfg.worldHeight * 0.5f;
+
+    void Step(ReplicationClient& client, int ticks = 1) {
+        for (int i = 0; i < ticks; ++i) {
+            server.Tick(1.0f / 30.0f);
+            client.Update(1.0f / 30.0f);
+        }
+    }
+};
+
+bool ClientSees(const ReplicationClient& client, uint32_t id) {
+    for (const RemoteEntity& e : client.Entities()) {
+        if (e.id == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// A static NPC leaves interest and comes straight back to the position the
+// client last acked. The removal reached the client but its ack was lost, so
+// the server must not assume the client still shows the NPC.
+void TestLostRemovalAck() {
+    Harness h;
+    const float nearX = h.centerX + 300.0f;
+    const uint32_t npc = h.server.SpawnEntity(nearX, h.centerY);
+    AckDroppingTransport transport(*h.clientTransport, npc);
+    ReplicationClient client(transport, h.serverTransport->LocalId());
+
+    h.Step(client, 10);
+    CHECK(client.Connected());
+    CHECK(ClientSees(client, npc));
+
+    transport.Arm(true);
+    h.server.SetEntityPosition(npc, h.centerX + 1500.0f, h.centerY);
+    h.Step(client);
+    CHECK(!ClientSees(client, npc));
+
+    h.server.SetEntityPosition(npc, nearX, h.centerY);
+    h.Step(client, 30);
+    CHECK(transport.Dropped() == 1);
+    CHECK(ClientSees(client, npc));
+}
+
+// An NPC is first sent, the ack is lost, and the NPC leaves interest before
+// the server learns anything. The client must still be told to remove it.
+void TestLostUpdateAck() {
+    Harness h;
+    const uint32_t far = h.server.SpawnEntity(h.centerX + 1500.0f, h.centerY);
+    AckDroppingTransport transport(*h.clientTransport, far);
+    ReplicationClient client(transport, h.serverTransport->LocalId());
+
+    h.Step(client, 10);
+    CHECK(client.Connected());
+    CHECK(!ClientSees(client, far));
+
+    transport.Arm(false);
+    h.server.SetEntityPosition(far, h.centerX + 300.0f, h.centerY);
+    h.Step(client);
+    CHECK(ClientSees(client, far));
+
+    h.server.SetEntityPosition(far, h.centerX + 1500.0f, h.centerY);
+    h.Step(client, 30);
+    CHECK(transport.Dropped() == 1);
+    CHECK(!ClientSees(client, far));
+}
+
+// An NPC is sent when it comes within the interest radius and removed when
+// it leaves.
+void TestInterestEnterLeave() {
+    Harness h;
+    const uint32_t npc = h.server.SpawnEntity(h.centerX + 1000.0f, h.centerY);
+    ReplicationClient client(*h.clientTransport, h.serverTransport->LocalId());
+
+    h.Step(client, 10);
+    CHECK(client.Connected());
+    CHECK(ClientSees(client, client.LocalEntity()));
+    CHECK(!ClientSees(client, npc));
+
+    h.server.SetEntityPosition(npc, h.centerX + 700.0f, h.centerY);
+    h.Step(client);
+    CHECK(ClientSees(client, npc));
+
+    h.server.SetEntityPosition(npc, h.centerX, h.centerY + 900.0f);
+    h.Step(client);
+    CHECK(!ClientSees(client, npc));
+
+    h.server.SetEntityPosition(npc, h.centerX + 500.0f, h.centerY + 500.0f);
+    h.Step(client);
+    CHECK(ClientSees(client, npc));
+}
+
+// With room for three updates per snapshot, the client's own entity goes
+// first, nearer NPCs before farther ones, and the rest follow on later ticks.
+void TestBudgetPriority() {
+    ReplicationConfig cfg;
+    cfg.snapshotBudgetBytes = 11 + 3 * 13; // header + three position updates
+    Harness h(cfg);
+    constexpr int kNpcs = 9;
+    uint32_t npcs[kNpcs];
+    for (int i = 0; i < kNpcs; ++i) {
+        npcs[i] = h.server.SpawnEntity(h.centerX + 100.0f + 60.0f * i, h.centerY);
+    }
+    ReplicationClient client(*h.clientTransport, h.serverTransport->LocalId());
+
+    int firstSeen[kNpcs];
+    int ownSeen = -1;
+    int deferredTicks = 0;
+    for (int& t : firstSeen) {
+        t = -1;
+    }
+    for (int step = 0; step < 20; ++step) {
+        h.Step(client);
+        deferredTicks += h.server.Stats().entriesDeferred > 0 ? 1 : 0;
+        if (ownSeen < 0 && client.Connected() && ClientSees(client, client.LocalEntity())) {
+            ownSeen = step;
+        }
+        for (int i = 0; i < kNpcs; ++i) {
+            if (firstSeen[i] < 0 && ClientSees(client, npcs[i])) {
+                firstSeen[i] = step;
+            }
+        }
+    }
+    CHECK(ownSeen >= 0 && ownSeen <= firstSeen[0]);
+    for (int i = 0; i < kNpcs; ++i) {
+        CHECK(firstSeen[i] >= 0);
+        CHECK(i == 0 || firstSeen[i] >= firstSeen[i - 1]);
+    }
+    // Own entity plus two NPCs, then three NPCs per tick.
+    CHECK(firstSeen[1] == ownSeen && firstSeen[2] > ownSeen);
+    CHECK(firstSeen[kNpcs - 1] - firstSeen[0] == 3);
+    CHECK(deferredTicks == 3);
+}
+
+// A client that goes silent is dropped after clientTimeout, together with its
+// player entity; one that keeps talking stays.
+void TestClientTimeout() {
+    ReplicationConfig cfg;
+    cfg.clientTimeout = 1.0f;
+    Harness h(cfg);
+    std::unique_ptr<LoopbackTransport> otherTransport = h.network.CreateEndpoint();
+    ReplicationClient silent(*h.clientTransport, h.serverTransport->LocalId());
+    ReplicationClient active(*otherTransport, h.serverTransport->LocalId());
+
+    for (int i = 0; i < 10; ++i) {
+        h.Step(silent);
+        active.Update(1.0f / 30.0f);
+    }
+    CHECK(silent.Connected() && active.Connected());
+    CHECK(h.server.ClientCount() == 2);
+    CHECK(h.server.Stats().entities == 2);
+    CHECK(ClientSees(active, silent.LocalEntity()));
+
+    // 0.9 s of silence is still within the timeout.
+    for (int i = 0; i < 27; ++i) {
+        h.server.Tick(1.0f / 30.0f);
+        active.Update(1.0f / 30.0f);
+    }
+    CHECK(h.server.ClientCount() == 2);
+
+    for (int i = 0; i < 6; ++i) {
+        h.server.Tick(1.0f / 30.0f);
+        active.Update(1.0f / 30.0f);
+    }
+    CHECK(h.server.ClientCount() == 1);
+    CHECK(h.server.Stats().entities == 1);
+    CHECK(!ClientSees(active, silent.LocalEntity()));
+}
+
+} // namespace
+
+int main() {
+    TestLostRemovalAck();
+    TestLostUpdateAck();
+    TestInterestEnterLeave();
+    TestBudgetPriority();
+    TestClientTimeout();
+    return ReportFailures("ReplicationTests");
+}
@@ -0,0 +1,47 @@
+#pragma once
+// Minimal checks shared by the test executables. A failed check prints its
+// location and the test carries on; main() ends with ReportFailures.
+#include <cmath>
+#include <cstdio>
+
+inline int g_testFailures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_testFailures;                                               \
+        }                                                                   \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                      \
+    do {                                                                    \
+        const long long va = static_cast<long long>(a);                     \
+        const long long vb = static_cast<long long>(b);                     \
+        if (va != vb) {                                                     \
+            std::printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld vs %lld\n",   \
+                        __FILE__, __LINE__, #a, #b, va, vb);                \
+            ++g_testFailures;                                               \
+        }                                                                   \
+    } while (0)
+
+#define CHECK_NEAR(a, b, eps)                                               \
+    do {                                                                    \
+        const double va = (a);                                              \
+        const double vb = (b);                                              \
+        if (std::fabs(va - vb) > (eps)) {                                   \
+            std::printf("%s:%d: CHECK_NEAR(%s, %s) failed: %.9f vs %.9f\n", \
+                        __FILE__, __LINE__, #a, #b, va, vb);                \
+            ++g_testFailures;                                               \
+        }                                                                   \
+    } while (0)
+
+// Prints the summary line; returns the process exit code.
+inline int ReportFailures(const char* name) {
+    if (g_testFailures) {
+        std::printf("%s: %d failure(s)\n", name, g_testFailures);
+        return 1;
+    }
+    std::printf("%s: ok\n", name);
+    return 0;
+}
@@ -0,0 +1,185 @@
+// World transforms against a naive parent walk and the threaded update
+// against a single-threaded one, dirty-subtree bookkeeping, and edits through
+// ids that are dead or would break the hierarchy.
+#include "../src/scene/TransformHierarchy.h"
+#include "TestCheck.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+bool Near(const Affine2D& a, const Affine2D& b) {
+    const float eps = 1e-3f;
+    return std::fabs(a.a - b.a) < eps && std::fabs(a.b - b.b) < eps && std::fabs(a.c - b.c) < eps &&
+           std::fabs(a.d - b.d) < eps && std::fabs(a.tx - b.tx) < eps && std::fabs(a.ty - b.ty) < eps;
+}
+
+Transform2D At(float x, float y, float rotation = 0.0f) {
+    Transform2D t;
+    t.x = x;
+    t.y = y;
+    t.rotation = rotation;
+    return t;
+}
+
+void TestMatchesParentWalk() {
+    TransformHierarchy h;
+    h.SetMaxThreads(1);
+    std::mt19937 rng(7);
+    std::vector<TransformId> ids;
+    std::vector<TransformId> parents;
+    for (int i = 0; i < 2000; ++i) {
+        const TransformId parent = i < 5 ? kInvalidTransform : ids[rng() % ids.size()];
+        ids.push_back(h.Create(parent));
+        parents.push_back(parent);
+        h.SetLocal(ids.back(), At(rng() % 50 * 1.0f, rng() % 50 * 1.0f, (rng() % 60) * 0.01f));
+    }
+
+    auto verify = [&] {
+        bool ok = true;
+        for (size_t i = 0; i < ids.size(); ++i) {
+            Affine2D expected = Affine2D::FromTransform(h.Local(ids[i]));
+            for (TransformId p = parents[i]; p != kInvalidTransform; p = parents[p]) {
+                expected = Affine2D::FromTransform(h.Local(p)) * expected;
+            }
+            ok = ok && Near(expected, h.World(ids[i]));
+        }
+        return ok;
+    };
+
+    h.Update();
+    CHECK(h.LastUpdatedCount() == ids.size());
+    CHECK(verify());
+
+    // Editing a leaf-ish node touches only its subtree.
+    h.SetLocal(ids[1500], At(3.0f, 4.0f));
+    h.Update();
+    CHECK(h.LastUpdatedCount() >= 1 && h.LastUpdatedCount() < ids.size());
+    CHECK(verify());
+
+    h.Update();
+    CHECK(h.LastUpdatedCount() == 0);
+
+    for (int i = 0; i < 500; ++i) {
+        const TransformId id = ids[rng() % ids.size()];
+        Transform2D t = h.Local(id);
+        t.rotation += 0.1f;
+        h.SetLocal(id, t);
+    }
+    h.Update();
+    CHECK(verify());
+}
+
+void TestStaleIdIgnored() {
+    TransformHierarchy h;
+    const TransformId root = h.Create();
+    const TransformId gone = h.Create(root);
+    const TransformId kept = h.Create(root);
+    h.SetLocal(root, At(10.0f, 0.0f));
+    h.SetLocal(kept, At(0.0f, 5.0f));
+    h.Update();
+
+    h.Destroy(gone);
+    h.Update(); // re-flattened: the slot gone held now belongs to another node
+    const Affine2D keptWorld = h.World(kept);
+    const Affine2D rootWorld = h.World(root);
+
+    h.SetLocal(gone, At(1000.0f, 1000.0f));
+    h.SetLocal(12345, At(1000.0f, 1000.0f)); // never created
+    h.Update();
+    CHECK(h.LastUpdatedCount() == 0);
+    CHECK(Near(h.World(kept), keptWorld));
+    CHECK(Near(h.World(root), rootWorld));
+    CHECK(h.Local(kept).y == 5.0f);
+}
+
+// SetParent refuses parents that would leave the node dangling or create a
+// cycle, and leaves the hierarchy as it was.
+void TestSetParentRejected() {
+    TransformHierarchy h;
+    const TransformId root = h.Create();
+    const TransformId child = h.Create(root);
+    const TransformId grandchild = h.Create(child);
+    const TransformId dead = h.Create();
+    h.SetLocal(root, At(10.0f, 0.0f));
+    h.SetLocal(child, At(0.0f, 5.0f));
+    h.SetLocal(grandchild, At(1.0f, 1.0f));
+    h.Destroy(dead);
+    h.Update();
+    const Affine2D childWorld = h.World(child);
+    const Affine2D grandchildWorld = h.World(grandchild);
+
+    h.SetParent(child, 12345);      // never created
+    h.SetParent(child, dead);       // destroyed
+    h.SetParent(child, child);      // itself
+    h.SetParent(child, grandchild); // its own descendant
+    h.SetParent(root, grandchild);
+    h.Update();
+    CHECK(h.LastUpdatedCount() == 0);
+    CHECK(Near(h.World(child), childWorld));
+    CHECK(Near(h.World(grandchild), grandchildWorld));
+
+    // Reads through ids that do not name a live node see the defaults.
+    CHECK(Near(h.World(dead), Affine2D()));
+    CHECK(Near(h.World(12345), Affine2D()));
+    CHECK(h.Local(12345).x == 0.0f && h.Local(12345).scaleX == 1.0f);
+}
+
+// Enough nodes to spread over threads, checked against the same hierarchy
+// updated on one thread. Both apply identical operations in the same order,
+// so the results must match exactly.
+void TestThreadedMatchesSingle() {
+    TransformHierarchy threaded;
+    TransformHierarchy single;
+    threaded.SetMaxThreads(4);
+    single.SetMaxThreads(1);
+    std::mt19937 rng(11);
+    std::vector<TransformId> ids;
+    for (int i = 0; i < 150000; ++i) {
+        const TransformId parent = i < 8 ? kInvalidTransform : ids[rng() % ids.size()];
+        const Transform2D local = At(rng() % 50 * 1.0f, rng() % 50 * 1.0f, (rng() % 60) * 0.01f);
+        ids.push_back(threaded.Create(parent));
+        CHECK(single.Create(parent) == ids.back());
+        threaded.SetLocal(ids.back(), local);
+        single.SetLocal(ids.back(), local);
+    }
+
+    auto same = [&] {
+        bool ok = true;
+        for (TransformId id : ids) {
+            const Affine2D& a = threaded.World(id);
+            const Affine2D& b = single.World(id);
+            ok = ok && a.a == b.a && a.b == b.b && a.c == b.c && a.d == b.d && a.tx == b.tx && a.ty == b.ty;
+        }
+        return ok;
+    };
+
+    threaded.Update();
+    single.Update();
+    CHECK(threaded.LastUpdatedCount() == ids.size());
+    CHECK(same());
+
+    // Move the roots: every subtree is dirty again, and the work is split
+    // below the roots.
+    for (int i = 0; i < 8; ++i) {
+        threaded.SetLocal(ids[i], At(1.0f, 2.0f, 0.3f));
+        single.SetLocal(ids[i], At(1.0f, 2.0f, 0.3f));
+    }
+    threaded.Update();
+    single.Update();
+    CHECK(threaded.LastUpdatedCount() == ids.size());
+    CHECK(same());
+}
+
+} // namespace
+
+int main() {
+    TestMatchesParentWalk();
+    TestStaleIdIgnored();
+    TestSetParentRejected();
+    TestThreadedMatchesSingle();
+    return ReportFailures("TransformHierarchyTests");
+}